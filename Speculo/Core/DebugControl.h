@@ -17,14 +17,18 @@ namespace Speculo
 
     enum class SpeculoResult
     {
+        SPECULO_SUCCESS,
         SPECULO_ERROR_FILESYSTEM_DIRECTORY_NOT_FOUND,
         SPECULO_ERROR_FILESYSTEM_FILE_NOT_FOUND,
         SPECULO_ERROR_FILESTREAM_UNOPEN,
         SPECULO_ERROR_SERIALIZATION_FAILURE,
         SPECULO_ERROR_DESERIALIZATION_FAILURE,
         SPECULO_ERROR_DESERIALIZATION_TYPE_MISMATCH,
+        SPECULO_ERROR_DESERIALIZATION_PROPERTY_NOT_FOUND,
+        SPECULO_ERROR_DESERIALIZATION_CONVERSION_FAILURE,
         SPECULO_ERROR_VERSION_MAJOR_MISMATCH,
         SPECULO_ERROR_VERSION_MINOR_MISMATCH,
+        SPECULO_ERROR_REFLECTION_FROZEN,
         SPECULO_WARNING_VERSION_REVISION_MISMATCH,
         SPECULO_WARNING_BEST_PRACTICES
     };
@@ -33,14 +37,18 @@ namespace Speculo
     {
         switch (result)
         {
+            case SpeculoResult::SPECULO_SUCCESS:                                    return "SPECULO_SUCCESS";
             case SpeculoResult::SPECULO_ERROR_FILESYSTEM_DIRECTORY_NOT_FOUND:       return "SPECULO_ERROR_FILESYSTEM_DIRECTORY_NOT_FOUND";
             case SpeculoResult::SPECULO_ERROR_FILESYSTEM_FILE_NOT_FOUND:            return "SPECULO_ERROR_FILESYSTEM_FILE_NOT_FOUND";
             case SpeculoResult::SPECULO_ERROR_FILESTREAM_UNOPEN:                    return "SPECULO_WARNING_FILESTREAM_UNOPEN";
             case SpeculoResult::SPECULO_ERROR_SERIALIZATION_FAILURE:                return "SPECULO_ERROR_SERIALIZATION_FAILURE";
             case SpeculoResult::SPECULO_ERROR_DESERIALIZATION_FAILURE:              return "SPECULO_ERROR_DESERIALIZATION_FAILURE";
             case SpeculoResult::SPECULO_ERROR_DESERIALIZATION_TYPE_MISMATCH:        return "SPECULO_ERROR_DESERIALIZATION_TYPE_MISMATCH";
+            case SpeculoResult::SPECULO_ERROR_DESERIALIZATION_PROPERTY_NOT_FOUND:   return "SPECULO_ERROR_DESERIALIZATION_PROPERTY_NOT_FOUND";
+            case SpeculoResult::SPECULO_ERROR_DESERIALIZATION_CONVERSION_FAILURE:   return "SPECULO_ERROR_DESERIALIZATION_CONVERSION_FAILURE";
             case SpeculoResult::SPECULO_ERROR_VERSION_MAJOR_MISMATCH:               return "SPECULO_ERROR_VERSION_MAJOR_MISMATCH";
             case SpeculoResult::SPECULO_ERROR_VERSION_MINOR_MISMATCH:               return "SPECULO_ERROR_VERSION_MINOR_MISMATCH";
+            case SpeculoResult::SPECULO_ERROR_REFLECTION_FROZEN:                    return "SPECULO_ERROR_REFLECTION_FROZEN";
             case SpeculoResult::SPECULO_WARNING_VERSION_REVISION_MISMATCH:          return "SPECULO_ERROR_VERSION_REVISION_MISMATCH";
             case SpeculoResult::SPECULO_WARNING_BEST_PRACTICES:                     return "SPECULO_WARNING_BEST_PRACTICES";
         }
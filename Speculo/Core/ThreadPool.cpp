@@ -0,0 +1,105 @@
+#include "SpeculoPCH.h"
+#include "ThreadPool.h"
+#include <utility>
+
+namespace Speculo
+{
+    ThreadPool::ThreadPool(uint32_t threadCount)
+    {
+        if (threadCount == 0)
+        {
+            threadCount = std::thread::hardware_concurrency();
+        }
+
+        threadCount = threadCount == 0 ? 1 : threadCount; // hardware_concurrency() is allowed to return 0 when it cannot tell.
+        m_Workers.reserve(threadCount);
+
+        for (uint32_t workerIndex = 0; workerIndex < threadCount; workerIndex++)
+        {
+            m_Workers.emplace_back(&ThreadPool::WorkerLoop, this, workerIndex);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_IsShuttingDown = true;
+        }
+
+        m_JobAvailable.notify_all();
+
+        for (std::thread& worker : m_Workers)
+        {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::Submit(std::function<void(uint32_t workerIndex)> job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Jobs.push(std::move(job));
+        }
+
+        m_JobAvailable.notify_one();
+    }
+
+    void ThreadPool::Wait()
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_JobsFinished.wait(lock, [this]() { return m_Jobs.empty() && m_ActiveJobs == 0; });
+
+        if (m_FirstException)
+        {
+            std::rethrow_exception(std::exchange(m_FirstException, nullptr));
+        }
+    }
+
+    void ThreadPool::WorkerLoop(uint32_t workerIndex)
+    {
+        while (true)
+        {
+            std::function<void(uint32_t)> job;
+
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_JobAvailable.wait(lock, [this]() { return m_IsShuttingDown || !m_Jobs.empty(); });
+
+                if (m_Jobs.empty()) // Only reachable once we are shutting down and all queued work has been drained.
+                {
+                    return;
+                }
+
+                job = std::move(m_Jobs.front());
+                m_Jobs.pop();
+                m_ActiveJobs++;
+            }
+
+            std::exception_ptr jobException;
+            try
+            {
+                job(workerIndex);
+            }
+            catch (...)
+            {
+                jobException = std::current_exception(); // Escaping would terminate the process and leave Wait() blocked on m_ActiveJobs.
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_ActiveJobs--;
+
+                if (jobException && !m_FirstException)
+                {
+                    m_FirstException = jobException;
+                }
+
+                if (m_Jobs.empty() && m_ActiveJobs == 0)
+                {
+                    m_JobsFinished.notify_all();
+                }
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace Speculo
+{
+    // A fixed set of worker threads pulling jobs from a shared FIFO queue. Every job is handed the index of the worker running it,
+    // which allows callers to keep per-worker scratch data (buffers, arenas) that is never shared between threads.
+    class ThreadPool
+    {
+    public:
+        explicit ThreadPool(uint32_t threadCount = 0); // 0 uses every hardware thread available.
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        void Submit(std::function<void(uint32_t workerIndex)> job);
+        void Wait(); // Blocks until every submitted job has finished, then rethrows the first exception a job let escape, if any.
+
+        uint32_t GetThreadCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+
+    private:
+        void WorkerLoop(uint32_t workerIndex);
+
+    private:
+        std::vector<std::thread> m_Workers;
+        std::queue<std::function<void(uint32_t)>> m_Jobs;
+
+        std::mutex m_Mutex;
+        std::condition_variable m_JobAvailable;
+        std::condition_variable m_JobsFinished;
+
+        std::exception_ptr m_FirstException; // Caught on the worker so it survives, handed back to the caller by Wait().
+        uint32_t m_ActiveJobs = 0;
+        bool m_IsShuttingDown = false;
+    };
+}
\ No newline at end of file
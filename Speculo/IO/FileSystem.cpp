@@ -1,6 +1,9 @@
 #include "SpeculoPCH.h"
 #include "FileSystem.h"
+#include <algorithm>
 #include <filesystem>
+#include <fstream>
+#include <vector>
 
 namespace Speculo
 {
@@ -50,4 +53,87 @@ namespace Speculo
             return filePath + fileExtension;
         }
     }
+
+    bool FileSystem::ReadFileContents(const std::string& filePath, std::string& fileContents)
+    {
+        std::ifstream inputStream(filePath, std::ios::binary | std::ios::ate);
+        if (inputStream.fail())
+        {
+            return false;
+        }
+
+        const std::streamsize fileSize = inputStream.tellg();
+        inputStream.seekg(0, std::ios::beg);
+
+        fileContents.resize(static_cast<size_t>(fileSize));
+        inputStream.read(fileContents.data(), fileSize);
+
+        return !inputStream.fail();
+    }
+
+    bool FileSystem::SpliceFileContents(const std::string& filePath, size_t offset, size_t replacedSize, const void* data, size_t dataSize)
+    {
+        std::error_code errorCode;
+        const uintmax_t fileSize = std::filesystem::file_size(filePath, errorCode);
+        if (errorCode || offset + replacedSize > fileSize)
+        {
+            return false;
+        }
+
+        std::fstream fileStream(filePath, std::ios::binary | std::ios::in | std::ios::out);
+        if (fileStream.fail())
+        {
+            return false;
+        }
+
+        if (dataSize != replacedSize)
+        {
+            constexpr size_t chunkSize = 1024 * 1024;
+            std::vector<char> chunk(chunkSize);
+
+            const size_t tailBegin = offset + replacedSize;
+            const size_t tailEnd = static_cast<size_t>(fileSize);
+            const size_t tailDestination = offset + dataSize;
+
+            auto moveChunk = [&](size_t chunkBegin, size_t chunkLength)
+            {
+                fileStream.seekg(static_cast<std::streamoff>(chunkBegin));
+                fileStream.read(chunk.data(), static_cast<std::streamsize>(chunkLength));
+                fileStream.seekp(static_cast<std::streamoff>(chunkBegin - tailBegin + tailDestination));
+                fileStream.write(chunk.data(), static_cast<std::streamsize>(chunkLength));
+            };
+
+            if (dataSize < replacedSize) // Shrinking: Walk forwards so that nothing is overwritten before it has been moved.
+            {
+                for (size_t chunkBegin = tailBegin; chunkBegin < tailEnd && !fileStream.fail(); chunkBegin += chunkSize)
+                {
+                    moveChunk(chunkBegin, std::min(chunkSize, tailEnd - chunkBegin));
+                }
+            }
+            else // Growing: Walk backwards for the same reason.
+            {
+                for (size_t chunkEnd = tailEnd; chunkEnd > tailBegin && !fileStream.fail(); chunkEnd -= std::min(chunkSize, chunkEnd - tailBegin))
+                {
+                    const size_t chunkLength = std::min(chunkSize, chunkEnd - tailBegin);
+                    moveChunk(chunkEnd - chunkLength, chunkLength);
+                }
+            }
+        }
+
+        fileStream.seekp(static_cast<std::streamoff>(offset));
+        fileStream.write(static_cast<const char*>(data), static_cast<std::streamsize>(dataSize));
+        fileStream.close();
+
+        if (fileStream.fail())
+        {
+            return false;
+        }
+
+        if (dataSize < replacedSize)
+        {
+            std::filesystem::resize_file(filePath, fileSize - (replacedSize - dataSize), errorCode);
+        }
+
+        return !errorCode;
+    }
 }
\ No newline at end of file
@@ -12,5 +12,12 @@ namespace Speculo
         static bool ValidateFileDirectory(const std::string& filePath);
         static bool ValidateFileExistence(const std::string& filePath);
         static std::string ValidateAndAppendFileExtension(const std::string& filePath, const std::string& fileExtension);
+
+        // Reads the whole file in a single pass. The destination string is reused, so callers looping over many files keep its capacity around.
+        static bool ReadFileContents(const std::string& filePath, std::string& fileContents);
+
+        // Replaces replacedSize bytes at offset with data. Equal sizes are overwritten in place, otherwise only the bytes following the
+        // replaced range are moved, in fixed size chunks, so that memory use stays flat however large the file is.
+        static bool SpliceFileContents(const std::string& filePath, size_t offset, size_t replacedSize, const void* data, size_t dataSize);
     };
 }
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "SpeculoPCH.h"
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Speculo
+{
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+#if defined(_WIN32)
+    bool MappedFile::Open(const std::string& filePath)
+    {
+        Close();
+
+        HANDLE fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) // Empty files cannot be mapped.
+        {
+            CloseHandle(fileHandle);
+            return false;
+        }
+
+        HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        const void* data = mappingHandle ? MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+
+        if (!data)
+        {
+            if (mappingHandle)
+            {
+                CloseHandle(mappingHandle);
+            }
+
+            CloseHandle(fileHandle);
+            return false;
+        }
+
+        m_FileHandle = fileHandle;
+        m_MappingHandle = mappingHandle;
+        m_Data = data;
+        m_Size = static_cast<size_t>(fileSize.QuadPart);
+
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (m_Data)
+        {
+            UnmapViewOfFile(m_Data);
+            CloseHandle(m_MappingHandle);
+            CloseHandle(m_FileHandle);
+        }
+
+        m_Data = nullptr;
+        m_Size = 0;
+        m_FileHandle = nullptr;
+        m_MappingHandle = nullptr;
+    }
+#else
+    bool MappedFile::Open(const std::string& filePath)
+    {
+        Close();
+
+        const int fileDescriptor = open(filePath.c_str(), O_RDONLY);
+        if (fileDescriptor < 0)
+        {
+            return false;
+        }
+
+        struct stat fileStatus;
+        if (fstat(fileDescriptor, &fileStatus) != 0 || fileStatus.st_size == 0) // Empty files cannot be mapped.
+        {
+            close(fileDescriptor);
+            return false;
+        }
+
+        void* data = mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+        close(fileDescriptor); // The mapping keeps the file alive on its own.
+
+        if (data == MAP_FAILED)
+        {
+            return false;
+        }
+
+        m_Data = data;
+        m_Size = static_cast<size_t>(fileStatus.st_size);
+
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (m_Data)
+        {
+            munmap(const_cast<void*>(m_Data), m_Size);
+        }
+
+        m_Data = nullptr;
+        m_Size = 0;
+    }
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace Speculo
+{
+    // Read only view of a whole file through the OS page cache. Nothing is copied up front, pages are faulted in as they are touched.
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool Open(const std::string& filePath);
+        void Close();
+
+        bool IsOpen() const { return m_Data != nullptr; }
+        const void* GetData() const { return m_Data; }
+        size_t GetSize() const { return m_Size; }
+
+    private:
+        const void* m_Data = nullptr;
+        size_t m_Size = 0;
+
+#if defined(_WIN32)
+        void* m_FileHandle = nullptr;
+        void* m_MappingHandle = nullptr;
+#endif
+    };
+}
\ No newline at end of file
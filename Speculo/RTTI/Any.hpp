@@ -3,6 +3,7 @@
 
 #include "TypeDescriptor.hpp"
 #include <cstddef>
+#include <cstring>
 #include <type_traits>
 #include <utility>
 #include <string>
@@ -42,12 +43,6 @@ namespace Speculo
         std::string m_Message;
     };
 
-    // Forward Declaration
-    template <std::size_t>
-    class BasicAny;
-
-    using Any = BasicAny<sizeof(void*)>;
-
     // AnyRef is an object that contains a pointer to any object but does not manage its lifetime.
     class AnyRef
     {
@@ -62,6 +57,9 @@ namespace Speculo
         template <std::size_t Size>
         AnyRef(BasicAny<Size>& any) : m_Instance(any.m_Instance), m_Type(any.m_Type) { }
 
+        // For type-erased callers that already hold the object's address alongside its type descriptor.
+        AnyRef(void* instance, const TypeDescriptor* type) : m_Instance(instance), m_Type(type) { }
+
     private:
         void* m_Instance; // Object we are pointing to. 
         const TypeDescriptor* m_Type; // Its Type Information.
@@ -118,21 +116,32 @@ namespace Speculo
         template <typename T>
         BasicAny TryConvert() const;
 
-        bool IsReference() const { return m_Copy == nullptr; } // Check if its a AnyRef.
+        bool IsReference() const { return m_Operations == nullptr; } // Check if its a AnyRef.
 
     private:
-        void* m_Instance;
-        Details::AlignedStorageT<Size> m_Storage;
-
-        const TypeDescriptor* m_Type;
-
         typedef void* (*CopyFunction)(void*, const void*);
         typedef void* (*MoveFunction)(void*, void*);
         typedef void (*DestroyFunction)(void*);
 
-        CopyFunction m_Copy;
-        MoveFunction m_Move;
-        DestroyFunction m_Destroy;
+        // How to copy, move and destroy one particular type. Shared by every Any holding that type, so each instance carries a single pointer.
+        struct Operations
+        {
+            CopyFunction m_Copy;
+            MoveFunction m_Move;
+            DestroyFunction m_Destroy; // Null for trivially destructible types stored inline.
+        };
+
+        template <typename T>
+        static const Operations* GetOperations();
+
+        void Reset();
+
+    private:
+        Details::AlignedStorageT<Size> m_Storage;
+        void* m_Instance;
+
+        const TypeDescriptor* m_Type;
+        const Operations* m_Operations; // Null for empty Anys and references.
 
         // Explicit Allocations (Fails SSO)
         template <typename T, typename = std::void_t<>>
@@ -169,9 +178,15 @@ namespace Speculo
             }
         };
 
+        template <typename T>
+        static constexpr bool IsStoredInline = sizeof(T) <= Size && alignof(T) <= alignof(std::max_align_t);
+
+        template <typename T>
+        static constexpr bool IsTrivial = std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>;
+
         // SSO
         template <typename T>
-        struct TypeTraits<T, typename std::enable_if<sizeof(T) <= Size>::type>
+        struct TypeTraits<T, typename std::enable_if<IsStoredInline<T> && !IsTrivial<T>>::type>
         {
             template <typename ...Args>
             static void* New(void* storage, Args&&... args)
@@ -202,34 +217,71 @@ namespace Speculo
                 static_cast<T*>(instance)->~T();
             }
         };
+
+        // SSO for trivially copyable types: Copies and moves are plain memcpys, and there is nothing to destroy.
+        template <typename T>
+        struct TypeTraits<T, typename std::enable_if<IsStoredInline<T> && IsTrivial<T>>::type>
+        {
+            template <typename ...Args>
+            static void* New(void* storage, Args&&... args)
+            {
+                new(storage) T(std::forward<Args>(args)...);
+
+                return storage;
+            }
+
+            static void* Copy(void* to, const void* from)
+            {
+                std::memcpy(to, from, sizeof(T));
+
+                return to;
+            }
+
+            static void* Move(void* to, void* from)
+            {
+                std::memcpy(to, from, sizeof(T));
+
+                return to;
+            }
+
+            static constexpr DestroyFunction Destroy = nullptr; // Destructors skip the call entirely.
+        };
     };
 
     template <std::size_t Size>
-    BasicAny<Size>::BasicAny() : m_Instance(nullptr), m_Copy(nullptr), m_Move(nullptr), m_Destroy(nullptr), m_Type(nullptr)
+    template <typename T>
+    const typename BasicAny<Size>::Operations* BasicAny<Size>::GetOperations()
+    {
+        static constexpr Operations operations { TypeTraits<T>::Copy, TypeTraits<T>::Move, TypeTraits<T>::Destroy }; // One table per stored type.
+        return &operations;
+    }
+
+    template <std::size_t Size>
+    BasicAny<Size>::BasicAny() : m_Instance(nullptr), m_Type(nullptr), m_Operations(nullptr)
     {
         new(&m_Storage) std::nullptr_t (nullptr);
     }
 
     template <std::size_t Size>
     template <typename T, typename U, typename>
-    BasicAny<Size>::BasicAny(T&& object) : m_Copy(TypeTraits<U>::Copy), m_Move(TypeTraits<U>::Move), m_Destroy(TypeTraits<U>::Destroy), m_Type(Details::Resolve<U>())
+    BasicAny<Size>::BasicAny(T&& object) : m_Type(Details::Resolve<U>()), m_Operations(GetOperations<U>())
     {
         m_Instance = TypeTraits<U>::New(&m_Storage, std::forward<T>(object));
     }
 
     template <std::size_t Size>
-    BasicAny<Size>::BasicAny(const BasicAny& other) : m_Copy(other.m_Copy), m_Move(other.m_Move), m_Destroy(other.m_Destroy), m_Type(other.m_Type)
+    BasicAny<Size>::BasicAny(const BasicAny& other) : m_Type(other.m_Type), m_Operations(other.m_Operations)
     {
-        m_Instance = other.m_Copy ? other.m_Copy(&m_Storage, other.m_Instance) : other.m_Instance;
+        m_Instance = other.m_Operations ? other.m_Operations->m_Copy(&m_Storage, other.m_Instance) : other.m_Instance;
     }
 
     template <std::size_t Size>
-    BasicAny<Size>::BasicAny(BasicAny&& other) : m_Copy(other.m_Copy), m_Move(other.m_Move), m_Destroy(other.m_Destroy), m_Type(other.m_Type)
+    BasicAny<Size>::BasicAny(BasicAny&& other) : m_Type(other.m_Type), m_Operations(other.m_Operations)
     {
-        if (other.m_Move)
+        if (other.m_Operations)
         {
-            m_Instance = other.m_Move(&m_Storage, other.m_Instance);
-            other.m_Destroy = nullptr;
+            m_Instance = other.m_Operations->m_Move(&m_Storage, other.m_Instance);
+            other.Reset(); // The value now lives here.
         }
         else
         {
@@ -247,12 +299,20 @@ namespace Speculo
     template <std::size_t Size>
     BasicAny<Size>::~BasicAny()
     {
-        if (m_Destroy)
+        if (m_Operations && m_Operations->m_Destroy)
         {
-            m_Destroy(m_Instance);
+            m_Operations->m_Destroy(m_Instance);
         }
     }
 
+    template <std::size_t Size>
+    void BasicAny<Size>::Reset()
+    {
+        m_Instance = nullptr;
+        m_Type = nullptr;
+        m_Operations = nullptr;
+    }
+
     template <std::size_t Size>
     template <typename T, typename U, typename>
     BasicAny<Size>& BasicAny<Size>::operator=(T&& object)
@@ -278,30 +338,32 @@ namespace Speculo
     template <std::size_t Size>
     void BasicAny<Size>::Swap(BasicAny& other)
     {
-        if (m_Move && other.m_Move)
+        if (m_Operations && other.m_Operations)
         {
             Details::AlignedStorageT<Size> temporaryStorage;
-            void* temporaryInstance = m_Move(&temporaryStorage, m_Instance);
-            m_Instance = other.m_Move(&m_Storage, other.m_Instance);
-            other.m_Instance = m_Move(&other.m_Storage, temporaryInstance);
+            void* temporaryInstance = m_Operations->m_Move(&temporaryStorage, m_Instance);
+            m_Instance = other.m_Operations->m_Move(&m_Storage, other.m_Instance);
+            other.m_Instance = m_Operations->m_Move(&other.m_Storage, temporaryInstance);
         }
-        else if (m_Move)
+        else if (m_Operations)
         {
-            other.m_Instance = m_Move(&other.m_Storage, m_Instance);
+            void* instance = other.m_Instance;
+            other.m_Instance = m_Operations->m_Move(&other.m_Storage, m_Instance);
+            m_Instance = instance;
         }
-        else if (other.m_Move)
+        else if (other.m_Operations)
         {
-            m_Instance = other.m_Move(&m_Storage, other.m_Instance);
+            void* instance = m_Instance;
+            m_Instance = other.m_Operations->m_Move(&m_Storage, other.m_Instance);
+            other.m_Instance = instance;
         }
         else
         {
-            m_Instance = other.m_Instance;
+            std::swap(m_Instance, other.m_Instance);
         }
 
         std::swap(m_Type, other.m_Type);
-        std::swap(m_Copy, other.m_Copy);
-        std::swap(m_Move, other.m_Move);
-        std::swap(m_Destroy, other.m_Destroy);
+        std::swap(m_Operations, other.m_Operations);
     }
 
     template <std::size_t Size>
@@ -326,7 +388,7 @@ namespace Speculo
     template <typename T>
     const T* BasicAny<Size>::TryCast() const
     {
-        const TypeDescriptor* typeDescriptor = typeDescriptor = Details::Resolve<T>();
+        const TypeDescriptor* typeDescriptor = Details::Resolve<T>();
         void* casted = nullptr;
 
         if (!*this) // If this Any instance isn't constructed, just cast immediately.
@@ -338,15 +400,9 @@ namespace Speculo
         {
             casted = m_Instance;
         }
-        else // Else, try to find the type within the typeDescriptor's list of base classes and see if a cast is possible. 
+        else // Else, see if the requested type is anywhere in our type's hierarchy. A single lookup however deep it is.
         {
-            for (auto* base : m_Type->GetBases())
-            {
-                if (base->GetType() == typeDescriptor)
-                {
-                    casted = base->Cast(m_Instance);
-                }
-            }
+            casted = m_Type->CastTo(m_Instance, typeDescriptor);
         }
 
         return static_cast<const T*>(casted); // Finally, cast.
@@ -374,14 +430,16 @@ namespace Speculo
         {
             converted = *this;
         }
-        else
+        else if constexpr (std::is_same_v<BasicAny, Any>) // Possibly through several registered conversions, i.e. int -> float -> double. The path is cached after the first lookup.
+        {
+            converted = m_Type->ConvertTo(m_Instance, typeDescriptor);
+        }
+        else // Conversions hand back an Any, so move the converted value out of it rather than boxing the Any itself.
         {
-            for (auto* conversion : m_Type->GetConversions())
+            Any convertedValue = m_Type->ConvertTo(m_Instance, typeDescriptor);
+            if (T* value = convertedValue.TryCast<T>())
             {
-                if (conversion->GetToType() == typeDescriptor)
-                {
-                    converted = conversion->Convert(m_Instance);
-                }
+                converted = std::move(*value);
             }
         }
 
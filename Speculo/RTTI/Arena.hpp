@@ -0,0 +1,120 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace Speculo
+{
+    // Bump allocator for objects built through reflection, i.e. Constructor::NewInstanceIn. Memory is handed out from large blocks
+    // and only ever released all at once. Non-trivial destructors registered alongside run, newest first, on Reset and destruction.
+    class Arena
+    {
+    public:
+        using DestroyFunction = void(*)(void*);
+
+        explicit Arena(size_t blockSize = 64 * 1024) : m_BlockSize(blockSize) { }
+        ~Arena() { Reset(); }
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        void* Allocate(size_t size, size_t alignment)
+        {
+            alignment = alignment ? alignment : 1;
+
+            while (m_BlockIndex < m_Blocks.size())
+            {
+                Block& block = m_Blocks[m_BlockIndex];
+                const uintptr_t blockBegin = reinterpret_cast<uintptr_t>(block.m_Memory.get());
+                const uintptr_t alignedAddress = (blockBegin + m_Offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+
+                if (alignedAddress + size <= blockBegin + block.m_Size)
+                {
+                    m_Offset = alignedAddress + size - blockBegin;
+                    return reinterpret_cast<void*>(alignedAddress);
+                }
+
+                m_BlockIndex++; // Blocks kept from before a Reset are reused before allocating new ones.
+                m_Offset = 0;
+            }
+
+            Block block;
+            block.m_Size = size + alignment > m_BlockSize ? size + alignment : m_BlockSize; // Oversized requests get a block of their own.
+            block.m_Memory = std::make_unique<unsigned char[]>(block.m_Size);
+
+            m_Blocks.push_back(std::move(block));
+            m_BlockIndex = m_Blocks.size() - 1;
+
+            return Allocate(size, alignment);
+        }
+
+        // Copies object into the arena. No destructor is recorded, so only use it for objects that own nothing, such as frozen reflection metadata.
+        template <typename Type>
+        Type* Copy(const Type& object)
+        {
+            return new (Allocate(sizeof(Type), alignof(Type))) Type(object);
+        }
+
+        // Runs destroy on count objects spaced stride bytes apart, starting at object.
+        void AddDestructor(void* object, DestroyFunction destroy, size_t count = 1, size_t stride = 0)
+        {
+            m_Destructors.push_back({ object, destroy, count, stride });
+        }
+
+        // Destroys everything constructed so far. The memory is kept for reuse.
+        void Reset()
+        {
+            for (auto destructor = m_Destructors.rbegin(); destructor != m_Destructors.rend(); ++destructor)
+            {
+                for (size_t i = destructor->m_Count; i > 0; i--)
+                {
+                    destructor->m_Destroy(static_cast<unsigned char*>(destructor->m_Object) + (i - 1) * destructor->m_Stride);
+                }
+            }
+
+            m_Destructors.clear();
+            m_BlockIndex = 0;
+            m_Offset = 0;
+        }
+
+        size_t GetCapacity() const
+        {
+            size_t capacity = 0;
+            for (const Block& block : m_Blocks)
+            {
+                capacity += block.m_Size;
+            }
+
+            return capacity;
+        }
+
+    private:
+        struct Block
+        {
+            std::unique_ptr<unsigned char[]> m_Memory;
+            size_t m_Size = 0;
+        };
+
+        struct Destructor
+        {
+            void* m_Object;
+            DestroyFunction m_Destroy;
+            size_t m_Count;
+            size_t m_Stride;
+        };
+
+    private:
+        size_t m_BlockSize;
+        std::vector<Block> m_Blocks;
+        size_t m_BlockIndex = 0;
+        size_t m_Offset = 0;      // Into m_Blocks[m_BlockIndex].
+
+        std::vector<Destructor> m_Destructors;
+    };
+}
+
+#endif // ARENA_H
\ No newline at end of file
@@ -2,32 +2,77 @@
 #define BASE_H
 
 #include "TypeDescriptor.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
 
 namespace Speculo
 {
+    namespace Details
+    {
+        // A virtual base (or an ambiguous one) cannot be reached from the derived type with a static_cast in the other direction.
+        template <typename BaseType, typename Derived, typename = void>
+        struct IsVirtualBaseOf : std::true_type { };
+
+        template <typename BaseType, typename Derived>
+        struct IsVirtualBaseOf<BaseType, Derived, std::void_t<decltype(static_cast<Derived*>(std::declval<BaseType*>()))>> : std::false_type { };
+    }
+
     class Base
     {
     public:
+        virtual ~Base() = default;
+
         const TypeDescriptor* GetType() const { return m_Type; }
         virtual void* Cast(void* object) = 0;
+        virtual Base* CopyTo(Arena& arena) const = 0;
+
+        // Byte offset of the base subobject within the derived object. Only meaningful for non-virtual bases, as a virtual base's position depends on the object.
+        std::ptrdiff_t GetOffset() const { return m_Offset; }
+        bool IsVirtual() const { return m_IsVirtual; }
 
     protected:
-        Base(const TypeDescriptor* type, const TypeDescriptor* parent) : m_Type(type), m_Parent(parent) {}
+        Base(const TypeDescriptor* type, const TypeDescriptor* parent, std::ptrdiff_t offset, bool isVirtual) : m_Type(type), m_Parent(parent), m_Offset(offset), m_IsVirtual(isVirtual) {}
 
     private:
         const TypeDescriptor* m_Type;   // Base 
         const TypeDescriptor* m_Parent; // Derived
+        std::ptrdiff_t m_Offset;
+        bool m_IsVirtual;
     };
 
-    template <typename Base, typename Derived>
+    template <typename BaseType, typename Derived>
     class BaseImplementation : public Base
     {
     public:
-        BaseImplementation() : Base(Details::Resolve<Base>(), Details::Resolve<Derived>()) {}
+        BaseImplementation() : Base(Details::Resolve<BaseType>(), Details::Resolve<Derived>(), ComputeOffset(), Details::IsVirtualBaseOf<BaseType, Derived>::value) {}
 
         void* Cast(void* object) override
         {
-            return static_cast<Base*>(object);
+            return static_cast<BaseType*>(static_cast<Derived*>(object));
+        }
+
+        Base* CopyTo(Arena& arena) const override
+        {
+            return arena.Copy(*this);
+        }
+
+    private:
+        static std::ptrdiff_t ComputeOffset()
+        {
+            if constexpr (Details::IsVirtualBaseOf<BaseType, Derived>::value)
+            {
+                return 0;
+            }
+            else
+            {
+                // Non-virtual base adjustments are fixed and never touch the object, so any suitably aligned non-null address will do.
+                const uintptr_t address = alignof(Derived) * 64;
+                Derived* derived = reinterpret_cast<Derived*>(address);
+
+                return reinterpret_cast<uintptr_t>(static_cast<BaseType*>(derived)) - address;
+            }
         }
     };
 }
@@ -1,10 +1,18 @@
 #ifndef CONSTRUCTOR_H
 #define CONSTRUCTOR_H
 
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <new>
 #include <vector>
 #include <tuple>
 #include "TypeDescriptor.hpp"
 #include "Any.hpp"
+#include "Arena.hpp"
+#include "Function.hpp"
 #include "Conversion.hpp"
 #include "Base.hpp"
 
@@ -12,38 +20,41 @@ namespace Speculo
 {
     inline bool CanCastOrConvert(const TypeDescriptor* from, const TypeDescriptor* to)
     {
-        if (from == to)
-        {
-            return true;
-        }
+        // Either To is From or one of its bases, or a chain of registered conversions leads there. Both are cached lookups.
+        return from->IsA(to) || from->CanConvertTo(to);
+    }
+    
+    class Constructor
+    {
+    public:
+        virtual ~Constructor() = default;
 
-        // If To is a base class type of From.
-        for (auto* base : from->GetBases())
+        Any NewInstance(std::vector<Any>& args)
         {
-            if (base->GetType() == to)
+            if (args.size() == m_ParameterTypes.size())
             {
-                return true;
+                return NewInstanceImplementation(args.data());
             }
+
+            return Any();
         }
 
-        // If To is a derived class of From. 
-        for (auto* conversion : from->GetConversions())
+        template <typename ...Args>
+        Any NewInstance(Args... args) const
         {
-            if (conversion->GetToType() == to)
+            if (sizeof...(Args) == m_ParameterTypes.size())
             {
-                return true;
+                std::array<Any, sizeof...(Args)> argumentFrame{ Any(std::forward<Args>(args))... };
+                return NewInstanceImplementation(argumentFrame.data());
             }
+
+            return Any();
         }
 
-        return false;
-    }
-    
-    class Constructor
-    {
-    public:
-        Any NewInstance(std::vector<Any>& args)
+        // For callers whose arguments are only known at runtime. Named apart from NewInstance for the same reason as Function::InvokeWithArguments.
+        Any NewInstanceWithArguments(Any* args, size_t argCount) const
         {
-            if (args.size() == m_ParameterTypes.size())
+            if (argCount == m_ParameterTypes.size())
             {
                 return NewInstanceImplementation(args);
             }
@@ -51,16 +62,50 @@ namespace Speculo
             return Any();
         }
 
+        // Constructs into caller owned storage of at least GetParent()->GetSize() bytes, suitably aligned. Returns the object, or nullptr if the arguments do not fit.
+        // The caller is responsible for destroying it, i.e. through Destroy.
         template <typename ...Args>
-        Any NewInstance(Args... args) const
+        void* NewInstanceAt(void* storage, Args&&... args) const
         {
-            if (sizeof...(Args) == m_ParameterTypes.size())
+            return ConstructN(storage, 1, std::forward<Args>(args)...);
+        }
+
+        // Constructs into memory taken from the arena, which also takes care of destroying the object.
+        template <typename ...Args>
+        void* NewInstanceIn(Arena& arena, Args&&... args) const
+        {
+            return ConstructN(arena, 1, std::forward<Args>(args)...);
+        }
+
+        // Constructs count contiguous objects from the same arguments, which are matched against the parameters once for the whole batch.
+        // If one of the constructors throws, the objects already built are destroyed before the exception is passed on.
+        template <typename ...Args>
+        void* ConstructN(void* storage, size_t count, Args&&... args) const
+        {
+            assert(reinterpret_cast<uintptr_t>(storage) % m_Parent->GetAlignment() == 0 && "Storage must be aligned for the constructed type.");
+            return ConstructInto(storage, nullptr, count, std::forward<Args>(args)...);
+        }
+
+        // Takes memory from the arena only once the arguments are known to fit.
+        template <typename ...Args>
+        void* ConstructN(Arena& arena, size_t count, Args&&... args) const
+        {
+            void* storage = ConstructInto(nullptr, &arena, count, std::forward<Args>(args)...);
+            if (storage && m_Destroy)
             {
-                std::vector<Any> argsAny = std::vector<Any>({ Any(std::forward<Args>(args))... });
-                return NewInstanceImplementation(argsAny);
+                arena.AddDestructor(storage, m_Destroy, count, m_Parent->GetSize());
             }
 
-            return Any();
+            return storage;
+        }
+
+        // Destroys an object built with NewInstanceAt/ConstructN(void*, ...), without freeing its storage.
+        void Destroy(void* object) const
+        {
+            if (m_Destroy)
+            {
+                m_Destroy(object);
+            }
         }
 
         const TypeDescriptor* GetParent() const
@@ -84,15 +129,48 @@ namespace Speculo
             return GetParameterCount() == sizeof...(Args) && ((Speculo::CanCastOrConvert(Details::Resolve<Args>(), GetParameterType(Indices))) && ...);
         }
 
+        // Copies this constructor into arena, i.e. when Freeze() compacts all metadata.
+        virtual Constructor* CopyTo(Arena& arena) const = 0;
+
     protected:
-        Constructor(TypeDescriptor* parent, const std::vector<const TypeDescriptor*> parameterTypes) : m_Parent(parent), m_ParameterTypes(parameterTypes) {}
+        using DestroyFunction = Arena::DestroyFunction;
+
+        Constructor(TypeDescriptor* parent, std::initializer_list<const TypeDescriptor*> parameterTypes, DestroyFunction destroy) : m_Parent(parent), m_ParameterTypes(Details::InternTypeList(parameterTypes)), m_Destroy(destroy) {}
+
+        template <typename Type>
+        static DestroyFunction GetDestroyFunction()
+        {
+            if constexpr (std::is_trivially_destructible_v<Type>)
+            {
+                return nullptr; // Nothing for arenas to record.
+            }
+            else
+            {
+                return [](void* object) { static_cast<Type*>(object)->~Type(); };
+            }
+        }
 
     private:
-        virtual Any NewInstanceImplementation(std::vector<Any>& args) const = 0;
+        // Either storage is given, or it is allocated from arena once the arguments have been matched.
+        template <typename ...Args>
+        void* ConstructInto(void* storage, Arena* arena, size_t count, Args&&... args) const
+        {
+            if (sizeof...(Args) == m_ParameterTypes.size())
+            {
+                std::array<Any, sizeof...(Args)> argumentFrame{ Any(std::forward<Args>(args))... };
+                return ConstructImplementation(storage, arena, count, argumentFrame.data());
+            }
+
+            return nullptr;
+        }
+
+        virtual Any NewInstanceImplementation(Any* args) const = 0;
+        virtual void* ConstructImplementation(void* storage, Arena* arena, size_t count, Any* args) const = 0;
 
     private:
         TypeDescriptor* m_Parent;
-        std::vector<const TypeDescriptor*> m_ParameterTypes;
+        Details::TypeList m_ParameterTypes;
+        DestroyFunction m_Destroy;
     };
 
     // One for each constructor type.
@@ -100,15 +178,14 @@ namespace Speculo
     class ConstructorImplementation : public Constructor
     {
     public:
-        ConstructorImplementation() : Constructor(Details::Resolve<Details::RawType<Type>>(), { Details::Resolve<Details::RawType<Args>>()... }) { }
+        ConstructorImplementation() : Constructor(Details::Resolve<Details::RawType<Type>>(), { Details::Resolve<Details::RawType<Args>>()... }, GetDestroyFunction<Type>()) { }
 
     private:
         template <size_t ...Indices>
-        Any NewInstanceImplementation(std::vector<Any>& args, std::index_sequence<Indices...> indexSequence) const
+        Any NewInstanceImplementation(Any* args, std::index_sequence<Indices...> indexSequence) const
         {
-            std::tuple argsTuple = std::make_tuple(args[Indices].TryCast<std::remove_cv_t<std::remove_reference_t<Args>>>()...);
-            std::vector<Any> convertedArgs{ (std::get<Indices>(argsTuple) ? AnyRef(*std::get<Indices>(argsTuple)) : args[Indices].TryConvert<std::remove_cv_t<std::remove_reference_t<Args>>>())... };
-            argsTuple = std::make_tuple(convertedArgs[indices].TryCast<std::remove_cv_t<std::remove_reference_t<Args>>>()...);
+            [[maybe_unused]] std::array<Any, sizeof...(Args)> convertedArgs;
+            std::tuple<Details::RawType<Args>*...> argsTuple{ Details::CastArgument<Details::RawType<Args>>(args[Indices], convertedArgs[Indices])... };
 
             if ((std::get<Indices>(argsTuple) && ...))
             {
@@ -118,10 +195,53 @@ namespace Speculo
             return Any();
         }
 
-        Any NewInstanceImplementation(std::vector<Any>& args) const override
+        template <size_t ...Indices>
+        void* ConstructImplementation(void* storage, Arena* arena, size_t count, Any* args, std::index_sequence<Indices...>) const
+        {
+            [[maybe_unused]] std::array<Any, sizeof...(Args)> convertedArgs;
+            std::tuple<Details::RawType<Args>*...> argsTuple{ Details::CastArgument<Details::RawType<Args>>(args[Indices], convertedArgs[Indices])... };
+
+            if (!(std::get<Indices>(argsTuple) && ...))
+            {
+                return nullptr;
+            }
+
+            if (!storage)
+            {
+                storage = arena->Allocate(sizeof(Type) * count, alignof(Type));
+            }
+
+            size_t constructedCount = 0;
+            try
+            {
+                for (; constructedCount < count; constructedCount++)
+                {
+                    new(static_cast<Type*>(storage) + constructedCount) Type(*std::get<Indices>(argsTuple)...);
+                }
+            }
+            catch (...)
+            {
+                std::destroy_n(static_cast<Type*>(storage), constructedCount);
+                throw;
+            }
+
+            return storage;
+        }
+
+        Constructor* CopyTo(Arena& arena) const override
+        {
+            return arena.Copy(*this);
+        }
+
+        Any NewInstanceImplementation(Any* args) const override
         {
             return NewInstanceImplementation(args, std::make_index_sequence<sizeof...(Args)>());
         }
+
+        void* ConstructImplementation(void* storage, Arena* arena, size_t count, Any* args) const override
+        {
+            return ConstructImplementation(storage, arena, count, args, std::make_index_sequence<sizeof...(Args)>());
+        }
     };
 
     template <typename Type, typename ...Args>
@@ -132,16 +252,15 @@ namespace Speculo
 
     public:
         FreeFunctionConstructor(ConstructorFunction constructorFunction) : 
-                                Constructor(Details::Resolve<Details::RawType<T>>(), { Details::Resolve<Details::RawType<Args>>()... }), m_ConstructorFunction(constructorFunction)
+                                Constructor(Details::Resolve<Details::RawType<Type>>(), { Details::Resolve<Details::RawType<Args>>()... }, GetDestroyFunction<Type>()), m_ConstructorFunction(constructorFunction)
         { }
 
     private:
         template <size_t ...Indices>
-        Any NewInstanceImplementation(std::vector<Any>& args, std::index_sequence<Indices...> indexSequence) const
+        Any NewInstanceImplementation(Any* args, std::index_sequence<Indices...> indexSequence) const
         {
-            std::tuple argsTuple = std::make_tuple(args[Indices].TryCast<std::remove_cv_t<std::remove_reference_t<Args>>>()...);
-            std::vector<Any> convertedArgs{ (std::get<Indices>(argsTuple) ? AnyRef(*std::get<Indices>(argsTuple)) : args[Indices].TryConvert<std::remove_cv_t<std::remove_reference_t<Args>>>())... };
-            argsTuple = std::make_tuple(convertedArgs[Indices].TryCast<std::remove_cv_t<std::remove_reference_t<Args>>>()...);
+            [[maybe_unused]] std::array<Any, sizeof...(Args)> convertedArgs;
+            std::tuple<Details::RawType<Args>*...> argsTuple{ Details::CastArgument<Details::RawType<Args>>(args[Indices], convertedArgs[Indices])... };
 
             if ((std::get<Indices>(argsTuple) && ...)) // Fold
             {
@@ -151,11 +270,54 @@ namespace Speculo
             return Any();
         }
 
-        Any NewInstanceImplementation(std::vector<Any>& args) const override
+        template <size_t ...Indices>
+        void* ConstructImplementation(void* storage, Arena* arena, size_t count, Any* args, std::index_sequence<Indices...>) const
+        {
+            [[maybe_unused]] std::array<Any, sizeof...(Args)> convertedArgs;
+            std::tuple<Details::RawType<Args>*...> argsTuple{ Details::CastArgument<Details::RawType<Args>>(args[Indices], convertedArgs[Indices])... };
+
+            if (!(std::get<Indices>(argsTuple) && ...))
+            {
+                return nullptr;
+            }
+
+            if (!storage)
+            {
+                storage = arena->Allocate(sizeof(Type) * count, alignof(Type));
+            }
+
+            size_t constructedCount = 0;
+            try
+            {
+                for (; constructedCount < count; constructedCount++)
+                {
+                    new(static_cast<Type*>(storage) + constructedCount) Type(m_ConstructorFunction(*std::get<Indices>(argsTuple)...)); // Elided straight into place.
+                }
+            }
+            catch (...)
+            {
+                std::destroy_n(static_cast<Type*>(storage), constructedCount);
+                throw;
+            }
+
+            return storage;
+        }
+
+        Constructor* CopyTo(Arena& arena) const override
+        {
+            return arena.Copy(*this);
+        }
+
+        Any NewInstanceImplementation(Any* args) const override
         {
             return NewInstanceImplementation(args, std::make_index_sequence<sizeof...(Args)>());
         }
 
+        void* ConstructImplementation(void* storage, Arena* arena, size_t count, Any* args) const override
+        {
+            return ConstructImplementation(storage, arena, count, args, std::make_index_sequence<sizeof...(Args)>());
+        }
+
     private:
         ConstructorFunction m_ConstructorFunction;
     };
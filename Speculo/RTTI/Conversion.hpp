@@ -9,10 +9,13 @@ namespace Speculo
     class Conversion
     {
     public:
+        virtual ~Conversion() = default;
+
         const TypeDescriptor* GetFromType() const { return m_FromType; }
         const TypeDescriptor* GetToType() const { return m_ToType; }
 
         virtual Any Convert(const void* object) const = 0;
+        virtual Conversion* CopyTo(Arena& arena) const = 0;
 
     protected:
         Conversion(const TypeDescriptor* from, const TypeDescriptor* to) : m_FromType(from), m_ToType(to) { }
@@ -33,6 +36,11 @@ namespace Speculo
         {
             return static_cast<To>(*static_cast<const From*>(object));
         }
+
+        Conversion* CopyTo(Arena& arena) const override
+        {
+            return arena.Copy(*this);
+        }
     };
 }
 
@@ -4,24 +4,34 @@
 #include "TypeDescriptor.hpp"
 #include "Any.hpp"
 #include <string>
+#include <string_view>
 
 namespace Speculo
 {
     class DataMember
     {
     public:
-        std::string GetName() const { return m_Name; }
+        virtual ~DataMember() = default;
+
+        std::string_view GetName() const { return m_Name; }
         const TypeDescriptor* GetParent() const { return m_Parent; }
         const TypeDescriptor* GetType() const { return m_Type; }
 
         virtual void Set(AnyRef objectRef, const Any value) = 0;
         virtual Any Get(Any object) = 0;
 
+        // Address of the member within an object of its parent type, or nullptr if the member is only reachable through a setter/getter pair.
+        // Allows callers such as serializers to read and write the member in place instead of boxing it into an Any.
+        virtual void* GetAddress(void*) const { return nullptr; }
+
+        // Copies this member into arena, i.e. when Freeze() compacts all metadata.
+        virtual DataMember* CopyTo(Arena& arena) const = 0;
+
     protected:
-        DataMember(const std::string& name, const TypeDescriptor* type, const TypeDescriptor* parent) : m_Name(name), m_Type(type), m_Parent(parent) { }
+        DataMember(std::string_view name, const TypeDescriptor* type, const TypeDescriptor* parent) : m_Name(Details::InternName(name)), m_Type(type), m_Parent(parent) { }
 
     private:
-        std::string m_Name;
+        std::string_view m_Name;            // Interned
         const TypeDescriptor* m_Type;       // Type of Data Member
         const TypeDescriptor* m_Parent;     // Type of Data Member's Class
     };
@@ -30,7 +40,7 @@ namespace Speculo
     class DataMemberPointer : public DataMember
     {
     public:
-        DataMemberPointer(Type Class::*dataMemberPointer, const std::string name) : DataMember(name, Details::Resolve<Type>(), Details::Resolve<Class>()), m_DataMemberPointer(dataMemberPointer)
+        DataMemberPointer(Type Class::*dataMemberPointer, std::string_view name) : DataMember(name, Details::Resolve<Type>(), Details::Resolve<Class>()), m_DataMemberPointer(dataMemberPointer)
         { }
 
         void Set(AnyRef objectRef, const Any value) override
@@ -40,14 +50,31 @@ namespace Speculo
 
         Any Get(Any object) override
         {
-            Class* object = object.TryCast<Class>();
+            Class* classObject = object.TryCast<Class>();
 
-            if (!object)
+            if (!classObject)
             {
                 throw BadCastException(Details::Resolve<Class>()->GetName(), object.GetType()->GetName());
             }
 
-            return object->*m_DataMemberPointer;
+            return classObject->*m_DataMemberPointer;
+        }
+
+        void* GetAddress(void* object) const override
+        {
+            if constexpr (std::is_const_v<Type>) // Const members must not be written through, so leave them to Get/Set.
+            {
+                return nullptr;
+            }
+            else
+            {
+                return &(static_cast<Class*>(object)->*m_DataMemberPointer);
+            }
+        }
+
+        DataMember* CopyTo(Arena& arena) const override
+        {
+            return arena.Copy(*this);
         }
 
     private:
@@ -112,7 +139,7 @@ namespace Speculo
         using MemberType = Details::RawType<typename decltype(ToFunctionHelper(Getter))::ReturnType>;
 
     public:
-        SetGetDataMember(const std::string& name) : DataMember(name, Details::Resolve<MemberType>(), Details::Resolve<Class>()) { }
+        SetGetDataMember(std::string_view name) : DataMember(name, Details::Resolve<MemberType>(), Details::Resolve<Class>()) { }
 
         void Set(AnyRef objectRef, const Any value) override
         {
@@ -168,6 +195,11 @@ namespace Speculo
                 return Getter(*classObject);
             }
         }
+
+        DataMember* CopyTo(Arena& arena) const override
+        {
+            return arena.Copy(*this);
+        }
     };
 }
 
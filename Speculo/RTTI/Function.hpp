@@ -1,32 +1,81 @@
 #ifndef MEMBER_FUNCTION_H
 #define MEMBER_FUNCTION_H
 
+#include <array>
+#include <initializer_list>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <tuple>
+#include <typeinfo>
 #include "TypeDescriptor.hpp"
 #include "Any.hpp"
 
 namespace Speculo
 {
+    namespace Details
+    {
+        // Casts an argument to its parameter type, falling back on a registered conversion whose result is kept alive in converted.
+        // Returns nullptr if neither applies. converted is only ever written to when a conversion is needed.
+        template <typename T>
+        T* CastArgument(Any& argument, Any& converted)
+        {
+            if (T* castedArgument = argument.TryCast<T>())
+            {
+                return castedArgument;
+            }
+
+            converted = argument.TryConvert<T>();
+            return converted.TryCast<T>();
+        }
+
+        using ErasedThunk = void(*)(); // Any function pointer type round trips through this one.
+    }
+
+    template <typename Signature>
+    class Invoker;
+
     class Function
     {
     public:
-        std::string GetName() const { return m_Name; }
+        virtual ~Function() = default;
+
+        std::string_view GetName() const { return m_Name; }
         const TypeDescriptor* GetParent() const { return m_Parent; }
 
+        // Arguments are boxed into a frame on the stack rather than a heap allocated vector.
         template <typename ...Args>
         Any Invoke(AnyRef object, Args&& ...args) const
         {
             if (sizeof...(Args) == m_ParameterTypes.size())
             {
-                std::vector<Any> anyArgs{ Any(std::forward<Args>(args))... };
-                return InvokeImplementation(object, anyArgs);
+                std::array<Any, sizeof...(Args)> argumentFrame{ Any(std::forward<Args>(args))... };
+                return InvokeImplementation(object, argumentFrame.data(), argumentFrame.size());
             }
 
             return Any();
         }
 
+        // For callers whose arguments are only known at runtime, such as script bindings. Named apart from Invoke so that
+        // a call passing an array and a count is never mistaken for a two argument Invoke.
+        Any InvokeWithArguments(AnyRef object, Any* args, size_t argCount) const
+        {
+            if (argCount == m_ParameterTypes.size())
+            {
+                return InvokeImplementation(object, args, argCount);
+            }
+
+            return Any();
+        }
+
+        // Resolves a typed handle once, i.e. Bind<int(Player&, float)>() for a member function or Bind<int(float)>() for a free one.
+        // Check the handle before use: It is empty unless Signature matches the reflected declaration exactly.
+        template <typename Signature>
+        Invoker<Signature> Bind() const
+        {
+            return Invoker<Signature>(this);
+        }
+
         const TypeDescriptor* GetReturnType() const
         {
             return m_ReturnType;
@@ -34,7 +83,7 @@ namespace Speculo
 
         std::vector<const TypeDescriptor*> GetParameterTypes() const
         {
-            return m_ParameterTypes;
+            return std::vector<const TypeDescriptor*>(m_ParameterTypes.begin(), m_ParameterTypes.end());
         }
 
         const TypeDescriptor* GetParameterType(size_t index) const
@@ -46,21 +95,61 @@ namespace Speculo
         {
             return m_ParameterTypes.size();
         }
+
+        // Copies this function into arena, i.e. when Freeze() compacts all metadata.
+        virtual Function* CopyTo(Arena& arena) const = 0;
         
     protected:
-        Function(const std::string& name, const TypeDescriptor* parent, const TypeDescriptor* returnType, const std::vector<const TypeDescriptor*> parameterTypes)
-            : m_Name(name), m_Parent(parent), m_ReturnType(returnType), m_ParameterTypes(parameterTypes) {}
+        Function(std::string_view name, const TypeDescriptor* parent, const TypeDescriptor* returnType, std::initializer_list<const TypeDescriptor*> parameterTypes)
+            : m_Name(Details::InternName(name)), m_Parent(parent), m_ReturnType(returnType), m_ParameterTypes(Details::InternTypeList(parameterTypes)) {}
             
         const TypeDescriptor* m_ReturnType;
-        std::vector<const TypeDescriptor*> m_ParameterTypes;
+        Details::TypeList m_ParameterTypes;
 
     private:
-        virtual Any InvokeImplementation(Any object, std::vector<Any>& args) const = 0;
+        virtual Any InvokeImplementation(Any object, Any* args, size_t argCount) const = 0;
+
+        // Returns a thunk of type Return(*)(const Function*, Params...) if signature is Return(Params...) for this function, nullptr otherwise.
+        virtual Details::ErasedThunk GetThunk(const std::type_info& signature) const = 0;
+
+        template <typename> friend class Invoker;
 
-        std::string m_Name;
+        std::string_view m_Name; // Interned
         const TypeDescriptor* const m_Parent;
     };
 
+    // A reflected function bound to a concrete signature. The signature is checked once when binding, after which a call is a
+    // single indirect call with no boxing or casts. Member functions take their object as the first parameter, by reference.
+    template <typename Return, typename ...Params>
+    class Invoker<Return(Params...)>
+    {
+    public:
+        Invoker() = default;
+
+        explicit Invoker(const Function* function) : m_Function(function)
+        {
+            if (function)
+            {
+                m_Thunk = reinterpret_cast<Thunk>(function->GetThunk(typeid(Return(Params...))));
+            }
+        }
+
+        explicit operator bool() const { return m_Thunk != nullptr; }
+
+        const Function* GetFunction() const { return m_Function; }
+
+        Return operator()(Params... params) const
+        {
+            return m_Thunk(m_Function, std::forward<Params>(params)...);
+        }
+
+    private:
+        using Thunk = Return(*)(const Function*, Params...);
+
+        const Function* m_Function = nullptr;
+        Thunk m_Thunk = nullptr;
+    };
+
     template <typename Return, typename ...Args>
     class FreeFunction : public Function
     {
@@ -68,17 +157,16 @@ namespace Speculo
         using FunctionPtr = Return(*)(Args...);
 
     public:
-        FreeFunction(FunctionPtr freeFunctionPtr, const std::string& name) : Function(name, nullptr, Details::Resolve<Return>(),
+        FreeFunction(FunctionPtr freeFunctionPtr, std::string_view name) : Function(name, nullptr, Details::Resolve<Return>(),
                                                                            { Details::Resolve<std::remove_cv_t<std::remove_reference_t<Args>>>()... }),
                                                                            m_FreeFunctionPtr(freeFunctionPtr) { }
 
     private:
         template <size_t ...Indices>
-        Any InvokeImplementation(std::vector<Any>& args, std::index_sequence<Indices...> indexSequence) const
+        Any InvokeImplementation(Any* args, std::index_sequence<Indices...> indexSequence) const
         {
-            std::tuple argsTuple = std::make_tuple(args[Indices].TryCast<std::remove_cv_t<std::remove_reference_t<Args>>>()...);
-            std::vector<Any> convertedArgs{ (std::get<Indices>(argsTuple) ? AnyRef(*std::get<Indices>(argsTuple)) : args[Indices].TryConvert<std::remove_cv_t<std::remove_reference_t<Args>>>())... };
-            argsTuple = std::make_tuple(convertedArgs[Indices].TryCast<std::remove_cv_t<std::remove_reference_t<Args>>>()...);
+            [[maybe_unused]] std::array<Any, sizeof...(Args)> convertedArgs;
+            std::tuple<Details::RawType<Args>*...> argsTuple{ Details::CastArgument<Details::RawType<Args>>(args[Indices], convertedArgs[Indices])... };
 
             if ((std::get<Indices>(argsTuple) && ...)) // All arguments are valid.
             {
@@ -97,11 +185,26 @@ namespace Speculo
             }
         }
 
-        Any InvokeImplementation(Any, std::vector<Any>&args) const override
+        Any InvokeImplementation(Any, Any* args, size_t) const override
         {
             return InvokeImplementation(args, std::index_sequence_for<Args...>());
         }
         
+        static Return Thunk(const Function* function, Args... args)
+        {
+            return static_cast<const FreeFunction*>(function)->m_FreeFunctionPtr(std::forward<Args>(args)...);
+        }
+
+        Function* CopyTo(Arena& arena) const override
+        {
+            return arena.Copy(*this);
+        }
+
+        Details::ErasedThunk GetThunk(const std::type_info& signature) const override
+        {
+            return signature == typeid(Return(Args...)) ? reinterpret_cast<Details::ErasedThunk>(&Thunk) : nullptr;
+        }
+
         private:
             FunctionPtr m_FreeFunctionPtr;      
     };
@@ -113,16 +216,15 @@ namespace Speculo
         using FunctionPtr = void(*)(Args...);
 
     public:
-        FreeFunction(FunctionPtr freeFunctionPtr, const std::string& name) : Function(name, nullptr, Details::Resolve<void>(), { Details::Resolve<std::remove_cv_t<std::remove_reference_t<Args>>>()... }),
+        FreeFunction(FunctionPtr freeFunctionPtr, std::string_view name) : Function(name, nullptr, Details::Resolve<void>(), { Details::Resolve<std::remove_cv_t<std::remove_reference_t<Args>>>()... }),
                                                                              m_FreeFunctionPtr(freeFunctionPtr) { }
 
     private:
         template <size_t ...Indices>
-        Any InvokeImplementation(std::vector<Any>& args, std::index_sequence<Indices...> indexSequence) const
+        Any InvokeImplementation(Any* args, std::index_sequence<Indices...> indexSequence) const
         {
-            std::tuple argsTuple = std::make_tuple(args[Indices].TryCast<std::remove_cv_t<std::remove_reference_t<Args>>>()...);
-            std::vector<Any> convertedArgs{ std::get<Indices>(argsTuple) ? AnyRef(*std::get<Indices>(argsTuple)) : args[Indices].TryConvert<std::remove_cv_t<std::add_lvalue_reference_t<Args>>>()... };
-            argsTuple = std::make_tuple(convertedArgs[Indices].TryCast<std::remove_cv_t<std::remove_reference_t<Args>>>()...);
+            [[maybe_unused]] std::array<Any, sizeof...(Args)> convertedArgs;
+            std::tuple<Details::RawType<Args>*...> argsTuple{ Details::CastArgument<Details::RawType<Args>>(args[Indices], convertedArgs[Indices])... };
 
             if ((std::get<Indices>(argsTuple) && ...)) // All arguments are valid.
             {
@@ -132,11 +234,26 @@ namespace Speculo
             return Any();
         }
 
-        Any InvokeImplementation(Any, std::vector<Any>& args) const override
+        Any InvokeImplementation(Any, Any* args, size_t) const override
         {
             return InvokeImplementation(args, std::index_sequence_for<Args...>());
         }
 
+        static void Thunk(const Function* function, Args... args)
+        {
+            return static_cast<const FreeFunction*>(function)->m_FreeFunctionPtr(std::forward<Args>(args)...);
+        }
+
+        Function* CopyTo(Arena& arena) const override
+        {
+            return arena.Copy(*this);
+        }
+
+        Details::ErasedThunk GetThunk(const std::type_info& signature) const override
+        {
+            return signature == typeid(void(Args...)) ? reinterpret_cast<Details::ErasedThunk>(&Thunk) : nullptr;
+        }
+
     private:
         FunctionPtr m_FreeFunctionPtr;
     };
@@ -148,17 +265,16 @@ namespace Speculo
         using MemberFunctionPtr = Return(C::*)(Args...);
 
     public:
-        MemberFunction(MemberFunctionPtr memberFunction, const std::string& name) : Function(name, Details::Resolve<C>(), Details::Resolve<Return>(),
+        MemberFunction(MemberFunctionPtr memberFunction, std::string_view name) : Function(name, Details::Resolve<C>(), Details::Resolve<Return>(),
                                                                                     { Details::Resolve<std::remove_cv_t<std::remove_reference_t<Args>>>()... }),
                                                                                     m_MemberFunctionPtr(memberFunction) { }
 
     private:
         template <size_t ...Indices>
-        Any InvokeImplementation(Any object, std::vector<Any>& args, std::index_sequence<Indices...> indexSequence) const
+        Any InvokeImplementation(Any object, Any* args, std::index_sequence<Indices...> indexSequence) const
         {
-            std::tuple argsTuple = std::make_tuple(args[Indices].TryCast<std::remove_cv_t<std::remove_reference_t<Args>>>()...);
-            std::vector<Any> convertedArgs{ (std::get<Indices>(argsTuple) ? AnyRef(*std::get<Indices>(argsTuple)) : args[Indices].TryConvert<std::remove_cv_t<std::remove_reference_t<Args>>>())... };
-            argsTuple = std::make_tuple(convertedArgs[Indices].TryCast<std::remove_cv_t<std::remove_reference_t<Args>>>()...);
+            [[maybe_unused]] std::array<Any, sizeof...(Args)> convertedArgs;
+            std::tuple<Details::RawType<Args>*...> argsTuple{ Details::CastArgument<Details::RawType<Args>>(args[Indices], convertedArgs[Indices])... };
 
             if (C* classObject = object.TryCast<C>(); (std::get<Indices>(argsTuple) && ...) && classObject) // Object can be casted and is valid + all arguments valid
             {
@@ -177,11 +293,26 @@ namespace Speculo
             }
         }
 
-        Any InvokeImplementation(Any object, std::vector<Any>& args) const override
+        Any InvokeImplementation(Any object, Any* args, size_t) const override
         {
             return InvokeImplementation(object, args, std::make_index_sequence<sizeof...(Args)>());
         }
 
+        static Return Thunk(const Function* function, C& object, Args... args)
+        {
+            return (object.*static_cast<const MemberFunction*>(function)->m_MemberFunctionPtr)(std::forward<Args>(args)...);
+        }
+
+        Function* CopyTo(Arena& arena) const override
+        {
+            return arena.Copy(*this);
+        }
+
+        Details::ErasedThunk GetThunk(const std::type_info& signature) const override
+        {
+            return signature == typeid(Return(C&, Args...)) ? reinterpret_cast<Details::ErasedThunk>(&Thunk) : nullptr;
+        }
+
     private:
         MemberFunctionPtr m_MemberFunctionPtr;
     };
@@ -193,16 +324,15 @@ namespace Speculo
         using MemberFunctionPtr = void(C::*)(Args...);
 
     public:
-        MemberFunction(MemberFunctionPtr memberFunction, const std::string& name) : Function(name, Details::Resolve<C>(), Details::Resolve<void>(),
+        MemberFunction(MemberFunctionPtr memberFunction, std::string_view name) : Function(name, Details::Resolve<C>(), Details::Resolve<void>(),
                                                                                    { Details::Resolve<std::remove_cv_t<std::remove_reference_t<Args>>>()... }), m_MemberFunctionPtr(memberFunction) { }
 
     private:
         template <size_t ...Indices>
-        Any InvokeImplementation(Any object, std::vector<Any>& args, std::index_sequence<Indices...> indexSequence) const
+        Any InvokeImplementation(Any object, Any* args, std::index_sequence<Indices...> indexSequence) const
         {
-            std::tuple argsTuple = std::make_tuple(args[Indices].TryCast<std::remove_cv_t<std::remove_reference_t<Args>>>()...);
-            std::vector<Any> convertedArgs{ (std::get<Indices>(argsTuple) ? AnyRef(*std::get<Indices>(argsTuple)) : args[Indices].TryConvert<std::remove_cv_t<std::remove_reference_t<Args>>>())... };
-            argsTuple = std::make_tuple(convertedArgs[Indices].TryCast<std::remove_cv_t<std::remove_reference_t<Args>>>()...);
+            [[maybe_unused]] std::array<Any, sizeof...(Args)> convertedArgs;
+            std::tuple<Details::RawType<Args>*...> argsTuple{ Details::CastArgument<Details::RawType<Args>>(args[Indices], convertedArgs[Indices])... };
 
             if (C* classObject = object.TryCast<C>(); (std::get<Indices>(argsTuple) && ...) && classObject)
             {
@@ -212,11 +342,26 @@ namespace Speculo
             return Any();
         }
 
-        Any InvokeImplementation(Any object, std::vector<Any>& args) const override
+        Any InvokeImplementation(Any object, Any* args, size_t) const override
         {
             return InvokeImplementation(object, args, std::make_index_sequence<sizeof...(Args)>());
         }
 
+        static void Thunk(const Function* function, C& object, Args... args)
+        {
+            return (object.*static_cast<const MemberFunction*>(function)->m_MemberFunctionPtr)(std::forward<Args>(args)...);
+        }
+
+        Function* CopyTo(Arena& arena) const override
+        {
+            return arena.Copy(*this);
+        }
+
+        Details::ErasedThunk GetThunk(const std::type_info& signature) const override
+        {
+            return signature == typeid(void(C&, Args...)) ? reinterpret_cast<Details::ErasedThunk>(&Thunk) : nullptr;
+        }
+
     private:
         MemberFunctionPtr m_MemberFunctionPtr;
     };
@@ -228,19 +373,18 @@ namespace Speculo
         using ConstMemberFunctionPtr = Return(C::*)(Args...) const;
 
     public:
-        ConstMemberFunction(ConstMemberFunctionPtr constMemberFunction, const std::string& name)
+        ConstMemberFunction(ConstMemberFunctionPtr constMemberFunction, std::string_view name)
                           : Function(name, Details::Resolve<C>(), Details::Resolve<Return>(), { Details::Resolve<std::remove_cv_t<std::remove_reference_t<Args>>>()...}),
                             m_ConstMemberFunctionPtr(constMemberFunction) { }
 
     private:
         template <size_t ...Indices>
-        Any InvokeImplementation(Any object, std::vector<Any>& args, std::index_sequence<Indices...> indexSequence) const
+        Any InvokeImplementation(Any object, Any* args, std::index_sequence<Indices...> indexSequence) const
         {
-            std::tuple argsTuple = std::make_tuple(args[Indices].TryCast<std::remove_cv_t<std::remove_reference_t<Args>>>()...);
-            std::vector<Any> convertedArgs{ (std::get<Indices>(argsTuple) ? AnyRef(*std::get<Indices>(argsTuple)) : args[Indices].TryConvert<std::remove_cv_t<std::remove_reference_t<Args>>>())... };
-            argsTuple = std::make_tuple(convertedArgs[Indices].TryCast<std::remove_cv_t<std::remove_reference_t<Args>>>()...);
+            [[maybe_unused]] std::array<Any, sizeof...(Args)> convertedArgs;
+            std::tuple<Details::RawType<Args>*...> argsTuple{ Details::CastArgument<Details::RawType<Args>>(args[Indices], convertedArgs[Indices])... };
 
-            if (C*  = object.TryCast<C>(); classObject && (std::get<Indices>(argsTuple) && ...))
+            if (C* classObject = object.TryCast<C>(); classObject && (std::get<Indices>(argsTuple) && ...))
             {
                 if constexpr (std::is_void<Return>::value)
                 {
@@ -251,7 +395,7 @@ namespace Speculo
                 {
                     if constexpr (std::is_reference_v<Return>)
                     {
-                        return AnyRef((classObject->m_ConstMemberFunctionPtr)(*std::get<Indices>(argsTuple)...));
+                        return AnyRef((classObject->*m_ConstMemberFunctionPtr)(*std::get<Indices>(argsTuple)...));
                     }
                     else
                     {
@@ -265,11 +409,36 @@ namespace Speculo
             }
         }
 
-        Any InvokeImplementation(Any object, std::vector<Any>& args) const override
+        Any InvokeImplementation(Any object, Any* args, size_t) const override
         {
             return InvokeImplementation(object, args, std::make_index_sequence<sizeof...(Args)>());
         }
 
+        static Return Thunk(const Function* function, const C& object, Args... args)
+        {
+            return (object.*static_cast<const ConstMemberFunction*>(function)->m_ConstMemberFunctionPtr)(std::forward<Args>(args)...);
+        }
+
+        static Return MutableThunk(const Function* function, C& object, Args... args)
+        {
+            return Thunk(function, object, std::forward<Args>(args)...);
+        }
+
+        Function* CopyTo(Arena& arena) const override
+        {
+            return arena.Copy(*this);
+        }
+
+        Details::ErasedThunk GetThunk(const std::type_info& signature) const override
+        {
+            if (signature == typeid(Return(const C&, Args...)))
+            {
+                return reinterpret_cast<Details::ErasedThunk>(&Thunk);
+            }
+
+            return signature == typeid(Return(C&, Args...)) ? reinterpret_cast<Details::ErasedThunk>(&MutableThunk) : nullptr;
+        }
+
     private:
         ConstMemberFunctionPtr m_ConstMemberFunctionPtr;
 
@@ -2,6 +2,8 @@
 #define REFLECT_H
 
 #include "TypeFactory.hpp"
+#include <mutex>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 
@@ -19,7 +21,7 @@ namespace Speculo
 
     // There are 3 ways to get the type descriptor of a type:
     // 1) With a template type parameter.
-    // 2) With the name of the type itself (string).
+    // 2) With the name of the type itself (string), or its TypeId. Neither allocates.
     // 3) With an instance of the object.
     // Each function calls the corresponding internal resolve and returns a const pointer to the type descriptor.
     template <typename Type>
@@ -28,20 +30,109 @@ namespace Speculo
         return Details::Resolve<Type>();
     }
 
-    template <typename T, typename = typename std::enable_if<!std::is_convertible<T, std::string>::value>::type>
+    template <typename T, typename = typename std::enable_if<!std::is_convertible<T, std::string_view>::value && !std::is_same<Details::RawType<T>, TypeId>::value>::type>
     const TypeDescriptor* Resolve(T&& object)
     {
         return Details::Resolve(std::forward<T>(object));
     }
 
-    inline const TypeDescriptor* Resolve(const std::string& name)
+    // Registration may rehash the registry, so lookups lock until Freeze() and are plain reads afterwards.
+    inline const TypeDescriptor* Resolve(std::string_view name)
     {
-        if (auto it = Details::GetTypeRegistry().find(name); it != Details::GetTypeRegistry().end())
+        if (Details::GetRegistrationFrozen().load(std::memory_order_acquire))
         {
-            return it->second;
+            return Details::GetTypeRegistry().Find(name);
         }
 
-        return nullptr;
+        std::lock_guard<std::recursive_mutex> registrationLock(Details::GetRegistrationMutex());
+        return Details::GetTypeRegistry().Find(name);
+    }
+
+    inline const TypeDescriptor* Resolve(TypeId typeId)
+    {
+        if (Details::GetRegistrationFrozen().load(std::memory_order_acquire))
+        {
+            return Details::GetTypeRegistry().Find(typeId);
+        }
+
+        std::lock_guard<std::recursive_mutex> registrationLock(Details::GetRegistrationMutex());
+        return Details::GetTypeRegistry().Find(typeId);
+    }
+
+    namespace Details
+    {
+        // Moves the metadata of every type registered through Reflect() into the arena. Call with the registration mutex held.
+        inline void CompactMetadata()
+        {
+            Arena& metadataArena = Details::GetMetadataArena();
+            size_t compactedCount = 0;
+
+            auto compactMetadata = [&metadataArena, &compactedCount](auto& entries)
+            {
+                for (auto& entry : entries)
+                {
+                    entry = entry->CopyTo(metadataArena); // The original is leaked like all other metadata, as callers may still hold on to it.
+                }
+
+                entries.shrink_to_fit();
+                compactedCount += entries.size();
+            };
+
+            for (TypeDescriptor* typeDescriptor : Details::GetTypeDescriptors())
+            {
+                if (typeDescriptor->m_IsCompacted)
+                {
+                    continue;
+                }
+
+                compactMetadata(typeDescriptor->m_DataMembers);
+                compactMetadata(typeDescriptor->m_MemberFunctions);
+                compactMetadata(typeDescriptor->m_Constructors);
+                compactMetadata(typeDescriptor->m_Bases);
+                compactMetadata(typeDescriptor->m_Conversions);
+                typeDescriptor->m_IsCompacted = true;
+            }
+
+            if (compactedCount > 0)
+            {
+                Details::GetRegistrationEpoch()++; // Every cached table still points at the originals.
+            }
+        }
+    }
+
+    // Call once every type has been reflected, i.e. at the end of startup. Compacts every DataMember, Function, Constructor, Base and Conversion
+    // into one contiguous arena, type by type, and builds every cached table (flattened members, ancestor sets, cast offsets and conversion paths)
+    // up front. Resolve and every lookup are lock free reads safe from any thread from then on.
+    // The originals are kept alive, so metadata pointers and Invokers obtained before the freeze stay valid, merely outside the arena.
+    // Lookups must not run on other threads meanwhile, as the tables built up during registration are released. For the same reason, lists returned
+    // by GetDataMembers() or GetMemberFunctions() before the freeze must be fetched again.
+    // Registering members afterwards is an error. Types first resolved after the freeze still work, building their tables once under the lock.
+    inline void Freeze()
+    {
+        std::lock_guard<std::recursive_mutex> registrationLock(Details::GetRegistrationMutex());
+
+        if (Details::GetRegistrationFrozen().load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        Details::CompactMetadata();
+
+        for (const TypeDescriptor* typeDescriptor : Details::GetTypeDescriptors())
+        {
+            typeDescriptor->GetMemberTable();
+            typeDescriptor->GetAncestorTable();
+            typeDescriptor->GetConversionCache();
+            Details::GetPublishedTable(typeDescriptor->m_ConstructorCache, [](TypeDescriptor::ConstructorCache&) {}); // Filled in as argument types are seen.
+
+            // The tables above stay current for good, so the builds they replaced can go.
+            Details::ReleaseSupersededTables(typeDescriptor->m_MemberTable);
+            Details::ReleaseSupersededTables(typeDescriptor->m_AncestorTable);
+            Details::ReleaseSupersededTables(typeDescriptor->m_ConversionCache);
+            Details::ReleaseSupersededTables(typeDescriptor->m_ConstructorCache);
+        }
+
+        Details::GetRegistrationFrozen().store(true, std::memory_order_release);
     }
 }
 
@@ -0,0 +1,441 @@
+#ifndef REFLECTION_IMAGE_H
+#define REFLECTION_IMAGE_H
+
+#include "Reflect.hpp"
+#include "IO/MappedFile.h"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Symbol table entries. Each names one piece of metadata by its C++ spelling, which is also what images refer to it by.
+#define SPECULO_SYMBOL_TYPE(Class)                      Speculo::ReflectionSymbol { Speculo::Details::HashName(#Class), Speculo::ReflectionSymbol::Kind::Type, #Class, &Speculo::ReflectionImage::BindType<Class>, &Speculo::Details::Resolve<Class> }
+#define SPECULO_SYMBOL_BASE(Class, BaseClass)           Speculo::ReflectionSymbol { Speculo::Details::HashName(#Class ":" #BaseClass), Speculo::ReflectionSymbol::Kind::Base, "", &Speculo::ReflectionImage::BindBase<BaseClass, Class>, &Speculo::Details::Resolve<Class> }
+#define SPECULO_SYMBOL_CONSTRUCTOR(Class, ...)          Speculo::ReflectionSymbol { Speculo::Details::HashName(#Class "(" #__VA_ARGS__ ")"), Speculo::ReflectionSymbol::Kind::Constructor, "", &Speculo::ReflectionImage::ConstructorBinder<Class(__VA_ARGS__)>::Bind, &Speculo::Details::Resolve<Class> }
+#define SPECULO_SYMBOL_DATA_MEMBER(Class, Member)       Speculo::ReflectionSymbol { Speculo::Details::HashName(#Class "::" #Member), Speculo::ReflectionSymbol::Kind::DataMember, #Member, &Speculo::ReflectionImage::BindDataMember<&Class::Member>, &Speculo::Details::Resolve<Class> }
+#define SPECULO_SYMBOL_MEMBER_FUNCTION(Class, Function) Speculo::ReflectionSymbol { Speculo::Details::HashName(#Class "::" #Function "()"), Speculo::ReflectionSymbol::Kind::MemberFunction, #Function, &Speculo::ReflectionImage::BindMemberFunction<&Class::Function>, &Speculo::Details::Resolve<Class> }
+#define SPECULO_SYMBOL_CONVERSION(Class, To)            Speculo::ReflectionSymbol { Speculo::Details::HashName(#Class "->" #To), Speculo::ReflectionSymbol::Kind::Conversion, "", &Speculo::ReflectionImage::BindConversion<Class, To>, &Speculo::Details::Resolve<Class> }
+
+namespace Speculo
+{
+    // The code half of one piece of reflection metadata, which an image cannot carry. Tables of these are plain constant data
+    // (write them by hand or generate them), so nothing runs at startup until an image is built or loaded from them:
+    //
+    //     constexpr Speculo::ReflectionSymbol GameSymbols[] =
+    //     {
+    //         SPECULO_SYMBOL_TYPE(Player),
+    //         SPECULO_SYMBOL_BASE(Player, Entity),
+    //         SPECULO_SYMBOL_CONSTRUCTOR(Player, int),
+    //         SPECULO_SYMBOL_DATA_MEMBER(Player, m_Health),
+    //         SPECULO_SYMBOL_MEMBER_FUNCTION(Player, TakeDamage),
+    //     };
+    struct ReflectionSymbol
+    {
+        using BindFunction = void*(*)(std::string_view name, Arena* arena);
+        using OwnerFunction = TypeDescriptor*(*)();
+
+        enum class Kind : uint32_t
+        {
+            Type,
+            Base,
+            Constructor,
+            DataMember,
+            MemberFunction,
+            Conversion
+        };
+
+        uint64_t m_Id;                  // Hash of the spelling given to the macro.
+        Kind m_Kind;
+        std::string_view m_DefaultName; // Registered name when building an image. Loading takes names from the image instead.
+        BindFunction m_Bind;            // Registers the metadata, in arena if given, and returns it.
+        OwnerFunction m_Owner;          // Resolves the type the metadata is registered on.
+    };
+
+    namespace Details
+    {
+        template <typename>
+        struct MemberPointerTraits;
+
+        template <typename C, typename T>
+        struct MemberPointerTraits<T C::*>
+        {
+            using Class = C;
+            using Type = T;
+        };
+    }
+
+    // A reflection database on disk: The names of every symbol and the flattened member tables of every type, laid out to be mapped
+    // and used in place. Use Load at startup instead of running registration code, and Build whenever it fails (first run, or a changed symbol table).
+    class ReflectionImage
+    {
+    public:
+        // Registers every symbol under its default name, writes the image to filePath and freezes. Returns false if the file could not be written,
+        // though reflection is ready to use either way.
+        template <size_t SymbolCount>
+        static bool Build(const std::string& filePath, const ReflectionSymbol (&symbols)[SymbolCount])
+        {
+            return Build(filePath, symbols, SymbolCount);
+        }
+
+        static bool Build(const std::string& filePath, const ReflectionSymbol* symbols, size_t symbolCount);
+
+        // Maps an image built from the same symbol table and registers straight out of it, then freezes. Names point into the mapping and member
+        // tables are taken as they are, so nothing is copied, hashed or sorted. Returns false without registering anything if the file is missing,
+        // malformed or was built from a different symbol table, or if any of its types already had metadata registered by other means, i.e. Reflect<T>().
+        template <size_t SymbolCount>
+        static bool Load(const std::string& filePath, const ReflectionSymbol (&symbols)[SymbolCount])
+        {
+            return Load(filePath, symbols, SymbolCount);
+        }
+
+        static bool Load(const std::string& filePath, const ReflectionSymbol* symbols, size_t symbolCount);
+
+        // Bind functions, as referenced by the SPECULO_SYMBOL_* macros.
+        template <typename Class>
+        static void* BindType(std::string_view name, Arena*)
+        {
+            typeFactory<Class>.ReflectType(std::string(name));
+            return Details::Resolve<Class>();
+        }
+
+        template <typename BaseClass, typename Class>
+        static void* BindBase(std::string_view, Arena* arena)
+        {
+            static_assert(std::is_base_of<BaseClass, Class>::value); // Base must be a base class of Class.
+
+            return AddMetadata(Details::Resolve<Class>(), Details::Resolve<Class>()->m_Bases, CreateMetadata<BaseImplementation<BaseClass, Class>>(arena), arena);
+        }
+
+        template <typename Signature>
+        struct ConstructorBinder;
+
+        template <typename Class, typename ...Args>
+        struct ConstructorBinder<Class(Args...)>
+        {
+            static void* Bind(std::string_view, Arena* arena)
+            {
+                return AddMetadata(Details::Resolve<Class>(), Details::Resolve<Class>()->m_Constructors, CreateMetadata<ConstructorImplementation<Class, Args...>>(arena), arena);
+            }
+        };
+
+        template <auto MemberPointer>
+        static void* BindDataMember(std::string_view name, Arena* arena)
+        {
+            using Class = typename Details::MemberPointerTraits<decltype(MemberPointer)>::Class;
+            using Type = typename Details::MemberPointerTraits<decltype(MemberPointer)>::Type;
+
+            return AddMetadata(Details::Resolve<Class>(), Details::Resolve<Class>()->m_DataMembers, CreateMetadata<DataMemberPointer<Class, Type>>(arena, MemberPointer, name), arena);
+        }
+
+        template <auto FunctionPointer>
+        static void* BindMemberFunction(std::string_view name, Arena* arena)
+        {
+            return CreateMemberFunction(FunctionPointer, name, arena);
+        }
+
+        template <typename From, typename To>
+        static void* BindConversion(std::string_view, Arena* arena)
+        {
+            static_assert(std::is_convertible<From, To>::value); // A conversion from From -> To must exist.
+
+            return AddMetadata(Details::Resolve<From>(), Details::Resolve<From>()->m_Conversions, CreateMetadata<ConversionImplementation<From, To>>(arena), arena);
+        }
+
+    private:
+        template <typename Metadata, typename ...Args>
+        static Metadata* CreateMetadata(Arena* arena, Args&&... args)
+        {
+            if (arena)
+            {
+                return new (arena->Allocate(sizeof(Metadata), alignof(Metadata))) Metadata(std::forward<Args>(args)...);
+            }
+
+            return new Metadata(std::forward<Args>(args)...);
+        }
+
+        template <typename Entry, typename Metadata>
+        static void* AddMetadata(TypeDescriptor* parent, std::vector<Entry*>& entries, Metadata* metadata, Arena* arena)
+        {
+            entries.push_back(metadata);
+            parent->m_IsCompacted |= arena != nullptr; // Freeze() must not try to move arena memory again.
+            Details::GetRegistrationEpoch()++;
+
+            return entries.back();
+        }
+
+        template <typename C, typename Return, typename ...Args>
+        static void* CreateMemberFunction(Return(C::*memberFunction)(Args...), std::string_view name, Arena* arena)
+        {
+            return AddMetadata(Details::Resolve<C>(), Details::Resolve<C>()->m_MemberFunctions, CreateMetadata<MemberFunction<C, Return, Args...>>(arena, memberFunction, name), arena);
+        }
+
+        template <typename C, typename Return, typename ...Args>
+        static void* CreateMemberFunction(Return(C::*constMemberFunction)(Args...) const, std::string_view name, Arena* arena)
+        {
+            return AddMetadata(Details::Resolve<C>(), Details::Resolve<C>()->m_MemberFunctions, CreateMetadata<ConstMemberFunction<C, Return, Args...>>(arena, constMemberFunction, name), arena);
+        }
+
+        // File layout, in this order: Header, SymbolRecord[SymbolCount], NameIndexRecord[IndexCount], TypeRecord[TypeCount], uint32_t[IndexCount] and the names.
+        // Every section starts suitably aligned, so a mapped image is read in place.
+        struct Header
+        {
+            uint32_t m_Magic;
+            uint32_t m_Version;
+            uint32_t m_SymbolCount;
+            uint32_t m_TypeCount;
+            uint32_t m_IndexCount;
+            uint32_t m_NamesSize;
+        };
+
+        struct SymbolRecord
+        {
+            uint64_t m_Id;
+            uint32_t m_NameOffset; // Names are null terminated.
+            uint32_t m_NameSize;
+        };
+
+        struct NameIndexRecord
+        {
+            uint64_t m_NameHash;
+            uint64_t m_Index;
+        };
+
+        // A type's flattened data members and member functions, as symbol indices. Both lists share their position in the name index.
+        struct TypeRecord
+        {
+            uint32_t m_Symbol;
+            uint32_t m_HasMemberTable; // Zero if some member was registered outside the symbol table, in which case the table is built on load.
+            uint32_t m_DataMemberBegin;
+            uint32_t m_DataMemberCount;
+            uint32_t m_FunctionBegin;
+            uint32_t m_FunctionCount;
+        };
+
+        static constexpr uint32_t m_Magic = 0x49525053; // "SPRI"
+        static constexpr uint32_t m_Version = 1;
+    };
+
+    inline bool ReflectionImage::Build(const std::string& filePath, const ReflectionSymbol* symbols, size_t symbolCount)
+    {
+        auto registrationLock = Details::LockRegistration();
+        if (!registrationLock)
+        {
+            return false;
+        }
+
+        std::vector<void*> boundMetadata(symbolCount);
+        std::unordered_map<const void*, uint32_t> symbolIndices;
+
+        for (size_t i = 0; i < symbolCount; i++)
+        {
+            boundMetadata[i] = symbols[i].m_Bind(symbols[i].m_DefaultName, nullptr);
+            symbolIndices.emplace(boundMetadata[i], static_cast<uint32_t>(i));
+        }
+
+        std::vector<SymbolRecord> symbolRecords;
+        std::vector<NameIndexRecord> nameIndexRecords;
+        std::vector<TypeRecord> typeRecords;
+        std::vector<uint32_t> indices;
+        std::string names;
+
+        for (size_t i = 0; i < symbolCount; i++)
+        {
+            symbolRecords.push_back({ symbols[i].m_Id, static_cast<uint32_t>(names.size()), static_cast<uint32_t>(symbols[i].m_DefaultName.size()) });
+            names.append(symbols[i].m_DefaultName);
+            names.push_back('\0');
+        }
+
+        auto appendMembers = [&](const auto& entries, const TypeDescriptor::NameIndex& nameIndex, uint32_t& begin, uint32_t& count) -> bool
+        {
+            begin = static_cast<uint32_t>(indices.size());
+            count = static_cast<uint32_t>(entries.size());
+
+            for (size_t i = 0; i < entries.size(); i++)
+            {
+                auto symbolIterator = symbolIndices.find(entries[i]);
+                if (symbolIterator == symbolIndices.end())
+                {
+                    return false;
+                }
+
+                indices.push_back(symbolIterator->second);
+                nameIndexRecords.push_back({ nameIndex[i].first, nameIndex[i].second });
+            }
+
+            return true;
+        };
+
+        for (size_t i = 0; i < symbolCount; i++)
+        {
+            if (symbols[i].m_Kind != ReflectionSymbol::Kind::Type)
+            {
+                continue;
+            }
+
+            const TypeDescriptor* typeDescriptor = static_cast<const TypeDescriptor*>(boundMetadata[i]);
+            const TypeDescriptor::MemberTable& memberTable = typeDescriptor->GetMemberTable();
+
+            TypeRecord typeRecord = { static_cast<uint32_t>(i), 1, 0, 0, 0, 0 };
+            const size_t previousIndexCount = indices.size();
+
+            if (!appendMembers(memberTable.m_DataMembers, memberTable.m_DataMemberIndex, typeRecord.m_DataMemberBegin, typeRecord.m_DataMemberCount) ||
+                !appendMembers(memberTable.m_MemberFunctions, memberTable.m_MemberFunctionIndex, typeRecord.m_FunctionBegin, typeRecord.m_FunctionCount))
+            {
+                indices.resize(previousIndexCount);
+                nameIndexRecords.resize(previousIndexCount);
+                typeRecord = { static_cast<uint32_t>(i), 0, 0, 0, 0, 0 };
+            }
+
+            typeRecords.push_back(typeRecord);
+        }
+
+        Freeze();
+
+        const Header header = { m_Magic, m_Version, static_cast<uint32_t>(symbolCount), static_cast<uint32_t>(typeRecords.size()), static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(names.size()) };
+
+        std::ofstream outputStream(filePath, std::ios::binary | std::ios::trunc);
+        outputStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        outputStream.write(reinterpret_cast<const char*>(symbolRecords.data()), symbolRecords.size() * sizeof(SymbolRecord));
+        outputStream.write(reinterpret_cast<const char*>(nameIndexRecords.data()), nameIndexRecords.size() * sizeof(NameIndexRecord));
+        outputStream.write(reinterpret_cast<const char*>(typeRecords.data()), typeRecords.size() * sizeof(TypeRecord));
+        outputStream.write(reinterpret_cast<const char*>(indices.data()), indices.size() * sizeof(uint32_t));
+        outputStream.write(names.data(), names.size());
+
+        return !outputStream.fail();
+    }
+
+    inline bool ReflectionImage::Load(const std::string& filePath, const ReflectionSymbol* symbols, size_t symbolCount)
+    {
+        std::unique_ptr<MappedFile> mappedImage = std::make_unique<MappedFile>();
+        if (!mappedImage->Open(filePath) || mappedImage->GetSize() < sizeof(Header))
+        {
+            return false;
+        }
+
+        const unsigned char* imageData = static_cast<const unsigned char*>(mappedImage->GetData());
+        const Header& header = *reinterpret_cast<const Header*>(imageData);
+
+        if (header.m_Magic != m_Magic || header.m_Version != m_Version || header.m_SymbolCount != symbolCount ||
+            mappedImage->GetSize() != sizeof(Header) + uint64_t(header.m_SymbolCount) * sizeof(SymbolRecord) + uint64_t(header.m_IndexCount) * sizeof(NameIndexRecord) +
+                                      uint64_t(header.m_TypeCount) * sizeof(TypeRecord) + uint64_t(header.m_IndexCount) * sizeof(uint32_t) + header.m_NamesSize)
+        {
+            return false;
+        }
+
+        const SymbolRecord* symbolRecords = reinterpret_cast<const SymbolRecord*>(imageData + sizeof(Header));
+        const NameIndexRecord* nameIndexRecords = reinterpret_cast<const NameIndexRecord*>(symbolRecords + header.m_SymbolCount);
+        const TypeRecord* typeRecords = reinterpret_cast<const TypeRecord*>(nameIndexRecords + header.m_IndexCount);
+        const uint32_t* indices = reinterpret_cast<const uint32_t*>(typeRecords + header.m_TypeCount);
+        const char* names = reinterpret_cast<const char*>(indices + header.m_IndexCount);
+
+        // Everything is checked before registering anything, so a stale image simply means building a new one.
+        for (size_t i = 0; i < symbolCount; i++)
+        {
+            const SymbolRecord& symbolRecord = symbolRecords[i];
+            if (symbolRecord.m_Id != symbols[i].m_Id || uint64_t(symbolRecord.m_NameOffset) + symbolRecord.m_NameSize >= header.m_NamesSize || names[symbolRecord.m_NameOffset + symbolRecord.m_NameSize] != '\0')
+            {
+                return false;
+            }
+        }
+
+        auto isValidMembers = [&](uint32_t begin, uint32_t count, ReflectionSymbol::Kind kind)
+        {
+            if (uint64_t(begin) + count > header.m_IndexCount)
+            {
+                return false;
+            }
+
+            for (uint32_t i = begin; i < begin + count; i++)
+            {
+                if (indices[i] >= symbolCount || symbols[indices[i]].m_Kind != kind || nameIndexRecords[i].m_Index >= count)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        };
+
+        for (uint32_t i = 0; i < header.m_TypeCount; i++)
+        {
+            const TypeRecord& typeRecord = typeRecords[i];
+            if (typeRecord.m_Symbol >= symbolCount || symbols[typeRecord.m_Symbol].m_Kind != ReflectionSymbol::Kind::Type ||
+                !isValidMembers(typeRecord.m_DataMemberBegin, typeRecord.m_DataMemberCount, ReflectionSymbol::Kind::DataMember) ||
+                !isValidMembers(typeRecord.m_FunctionBegin, typeRecord.m_FunctionCount, ReflectionSymbol::Kind::MemberFunction))
+            {
+                return false;
+            }
+        }
+
+        auto registrationLock = Details::LockRegistration();
+        if (!registrationLock)
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < symbolCount; i++) // Registering on top of that metadata would add every member twice, and leave the image's member tables incomplete.
+        {
+            const TypeDescriptor* owner = symbols[i].m_Owner();
+            if (!owner->m_Bases.empty() || !owner->m_Conversions.empty() || !owner->m_Constructors.empty() || !owner->m_DataMembers.empty() || !owner->m_MemberFunctions.empty())
+            {
+                return false;
+            }
+        }
+
+        Arena& metadataArena = Details::GetMetadataArena();
+
+        std::vector<void*> boundMetadata(symbolCount);
+        for (size_t i = 0; i < symbolCount; i++)
+        {
+            const std::string_view name(names + symbolRecords[i].m_NameOffset, symbolRecords[i].m_NameSize);
+            Details::GetInternedNames().insert(name); // So that the metadata below refers to the mapping rather than copies.
+
+            boundMetadata[i] = symbols[i].m_Bind(name, &metadataArena);
+        }
+
+        // Types outside the image are compacted now rather than in Freeze() below, whose epoch bump would discard the tables published here.
+        Details::CompactMetadata();
+
+        const uint64_t registrationEpoch = Details::GetRegistrationEpoch().load(std::memory_order_acquire);
+        for (uint32_t i = 0; i < header.m_TypeCount; i++)
+        {
+            const TypeRecord& typeRecord = typeRecords[i];
+            if (!typeRecord.m_HasMemberTable)
+            {
+                continue;
+            }
+
+            const TypeDescriptor* typeDescriptor = static_cast<const TypeDescriptor*>(boundMetadata[typeRecord.m_Symbol]);
+            std::unique_ptr<TypeDescriptor::MemberTable> memberTable = std::make_unique<TypeDescriptor::MemberTable>();
+            memberTable->m_Epoch = registrationEpoch;
+
+            for (uint32_t j = typeRecord.m_DataMemberBegin; j < typeRecord.m_DataMemberBegin + typeRecord.m_DataMemberCount; j++)
+            {
+                memberTable->m_DataMembers.push_back(static_cast<DataMember*>(boundMetadata[indices[j]]));
+                memberTable->m_DataMemberIndex.emplace_back(nameIndexRecords[j].m_NameHash, static_cast<size_t>(nameIndexRecords[j].m_Index));
+            }
+
+            for (uint32_t j = typeRecord.m_FunctionBegin; j < typeRecord.m_FunctionBegin + typeRecord.m_FunctionCount; j++)
+            {
+                memberTable->m_MemberFunctions.push_back(static_cast<Function*>(boundMetadata[indices[j]]));
+                memberTable->m_MemberFunctionIndex.emplace_back(nameIndexRecords[j].m_NameHash, static_cast<size_t>(nameIndexRecords[j].m_Index));
+            }
+
+            Details::PublishTable(typeDescriptor->m_MemberTable, std::move(memberTable));
+        }
+
+        mappedImage.release(); // Names point into the mapping, which stays for the rest of the program like all other metadata.
+        Freeze();
+
+        return true;
+    }
+}
+
+#endif // REFLECTION_IMAGE_H
\ No newline at end of file
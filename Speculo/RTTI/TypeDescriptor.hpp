@@ -1,10 +1,27 @@
 #ifndef TYPE_DESCRIPTOR_H
 #define TYPE_DESCRIPTOR_H
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
-#include <map>
 #include <type_traits>
+#include "../Core/DebugControl.h"
+#include "TypeId.hpp"
+#include "TypeRegistry.hpp"
+#include "Arena.hpp"
 
 namespace Speculo
 {
@@ -15,10 +32,65 @@ namespace Speculo
     class Base;                 // Base Classes
     class Conversion;           // Type Conversion Operators
 
+    // Inline capacity of Any, in bytes. Anything larger (or over-aligned) is boxed on the heap instead.
+    // The default fits Vector3, std::string and most small value types. Define before including to override.
+#if !defined(SPECULO_ANY_STORAGE_SIZE)
+#define SPECULO_ANY_STORAGE_SIZE 32
+#endif
+
+    template <std::size_t>
+    class BasicAny;             // Type Erased Values
+
+    using Any = BasicAny<SPECULO_ANY_STORAGE_SIZE>;
+
     template <typename>
     class TypeFactory;
 
     class TypeDescriptor;
+    class ReflectionImage;
+
+    namespace Details
+    {
+        // A run of parameter types interned in the metadata arena. Metadata holding one owns nothing on the heap and can be copied around freely.
+        class TypeList
+        {
+        public:
+            TypeList() = default;
+            TypeList(const TypeDescriptor* const* types, size_t size) : m_Types(types), m_Size(size) { }
+
+            size_t size() const { return m_Size; }
+            const TypeDescriptor* operator[](size_t index) const { return m_Types[index]; }
+
+            const TypeDescriptor* const* begin() const { return m_Types; }
+            const TypeDescriptor* const* end() const { return m_Types + m_Size; }
+
+        private:
+            const TypeDescriptor* const* m_Types = nullptr;
+            size_t m_Size = 0;
+        };
+
+        // Cached tables are built off to the side and published whole through an atomic pointer, never modified in place. Superseded builds are kept
+        // alive, as lock free readers may still be walking them or holding on to what they found there. Registration supersedes the tables of every
+        // type, so they add up over startup until Freeze() releases them.
+        template <typename Table>
+        struct PublishedTable
+        {
+            std::atomic<Table*> m_Current { nullptr };
+            std::vector<std::unique_ptr<Table>> m_Builds; // Every build so far. Guarded by the registration mutex.
+        };
+
+        // Returns the current table, building a new one first if it was built before the latest registration. Table needs an m_Epoch.
+        template <typename Table, typename BuildTable>
+        Table& GetPublishedTable(PublishedTable<Table>& publishedTable, BuildTable buildTable);
+
+        // Call with the registration mutex held.
+        template <typename Table>
+        Table& PublishTable(PublishedTable<Table>& publishedTable, std::unique_ptr<Table> table);
+
+        // Frees every build but the current one. Call with the registration mutex held, and only while no lookup runs on another thread.
+        template <typename Table>
+        void ReleaseSupersededTables(PublishedTable<Table>& publishedTable);
+    }
 
     // Forward Declarations (For Friend Declarations inside TypeDescriptor)
     namespace Details
@@ -28,6 +100,8 @@ namespace Speculo
 
         template <typename Type>
         TypeDescriptor* Resolve(Type&&);
+
+        void CompactMetadata();
     }
 
     class TypeDescriptor
@@ -67,38 +141,147 @@ namespace Speculo
         // Retrievals
         const std::string& GetName() const;
 
-        std::vector<Constructor*> GetConstructors() const;
+        TypeId GetTypeId() const;
+
+        std::size_t GetSize() const;
 
+        std::size_t GetAlignment() const;
+
+        const std::vector<Constructor*>& GetConstructors() const;
+
+        // Overload resolution: Exact parameter matches beat base class casts, which beat conversions (the fewer hops the better).
+        // Results are cached per list of argument types, so repeated lookups are a single hash probe.
         template <typename ...Args>
         const Constructor* GetConstructor() const;
 
-        std::vector<Base*> GetBases() const;
+        const Constructor* GetConstructor(const std::vector<const TypeDescriptor*>& argumentTypes) const;
+
+        // Picks the best constructor for the runtime types of args and runs it, converting arguments up front where the cached plan says so.
+        Any NewInstance(std::vector<Any>& args) const;
+
+        // Direct bases only. See IsA/CastTo for the whole hierarchy.
+        const std::vector<Base*>& GetBases() const;
 
         template <typename B>
         Base* GetBase() const;
 
-        std::vector<DataMember*> GetDataMembers() const;
+        // True if type is this type or any (possibly indirect) base of it. Constant time through a per type ancestor table.
+        bool IsA(const TypeDescriptor* type) const;
+
+        // Adjusts a pointer to an object of this type into a pointer to its type subobject, or returns nullptr if type is not an ancestor.
+        void* CastTo(void* object, const TypeDescriptor* type) const;
+
+        // Members of this type followed by those of its bases, flattened once and cached until the next registration.
+        const std::vector<DataMember*>& GetDataMembers() const;
+
+        DataMember* GetDataMember(std::string_view name) const;
 
-        DataMember* GetDataMember(const std::string& name) const;
+        const std::vector<Function*>& GetMemberFunctions() const;
 
-        std::vector<Function*> GetMemberFunctions() const; 
-         
-        const Function* GetMemberFunction(const std::string& name) const;
+        const Function* GetMemberFunction(std::string_view name) const;
 
-        std::vector<Conversion*> GetConversions() const;
+        const std::vector<Conversion*>& GetConversions() const;
 
         template <typename To>
         Conversion* GetConversion() const;
 
+        // The shortest chain of registered conversions leading from this type to another. One breadth first search finds the path to every reachable target at once.
+        // Empty if there is none, or if to is this type.
+        const std::vector<Conversion*>& GetConversionPath(const TypeDescriptor* to) const;
+
+        bool CanConvertTo(const TypeDescriptor* to) const;
+
+        // Applies each conversion of the path in turn. Returns an empty Any if to cannot be reached.
+        Any ConvertTo(const void* object, const TypeDescriptor* to) const;
+
+    private:
+        using NameIndex = std::vector<std::pair<uint64_t, size_t>>; // (Name hash, index into the flattened table), sorted by hash.
+
+        struct MemberTable
+        {
+            uint64_t m_Epoch = 0; // Registration epoch the table was built at.
+
+            std::vector<DataMember*> m_DataMembers;
+            std::vector<Function*> m_MemberFunctions;
+            NameIndex m_DataMemberIndex;
+            NameIndex m_MemberFunctionIndex;
+        };
+
+        const MemberTable& GetMemberTable() const;
+
+        template <typename Entry>
+        static void BuildNameIndex(const std::vector<Entry*>& entries, NameIndex& nameIndex);
+
+        template <typename Entry>
+        static Entry* FindByName(const std::vector<Entry*>& entries, const NameIndex& nameIndex, std::string_view name);
+
+        struct Ancestor
+        {
+            const TypeDescriptor* m_Type = nullptr; // Null for empty slots.
+            std::ptrdiff_t m_Offset = 0;            // Static cast offset from this type, when no virtual base lies on the path.
+            std::vector<Base*> m_CastChain;         // Otherwise, the casts to walk at runtime.
+        };
+
+        // Open addressing set of every ancestor, kept at most half full.
+        struct AncestorTable
+        {
+            uint64_t m_Epoch = 0;
+            std::vector<Ancestor> m_Slots;
+        };
+
+        struct ConversionCache
+        {
+            uint64_t m_Epoch = 0;
+            std::unordered_map<const TypeDescriptor*, std::vector<Conversion*>> m_Paths; // Every reachable target. Complete once built, so lookups never insert.
+        };
+
+        struct ConstructorMatch
+        {
+            std::vector<const TypeDescriptor*> m_ArgumentTypes;
+            const Constructor* m_Constructor = nullptr;       // Null if no constructor accepts these arguments.
+            std::vector<const TypeDescriptor*> m_Conversions; // Per argument, the parameter type to convert to first. Null if it can be passed or cast as is.
+
+            uint64_t m_Hash = 0;                // Of the argument types.
+            ConstructorMatch* m_Next = nullptr; // Within the same bucket. Never changes once published.
+        };
+
+        // Matches are pushed onto per bucket lists under the registration mutex and published with a release store,
+        // so lookups walk them without taking any lock. A registration publishes a fresh, empty cache rather than clearing this one.
+        struct ConstructorCache
+        {
+            static constexpr size_t m_BucketCount = 16; // Power of two.
+
+            uint64_t m_Epoch = 0;
+            std::array<std::atomic<ConstructorMatch*>, m_BucketCount> m_Buckets {};
+            std::vector<std::unique_ptr<ConstructorMatch>> m_Matches; // Owns every node in the buckets.
+        };
+
+        template <typename GetArgumentType>
+        const ConstructorMatch& FindConstructorMatch(size_t argumentCount, GetArgumentType getArgumentType) const;
+
+        const AncestorTable& GetAncestorTable() const;
+        const ConversionCache& GetConversionCache() const;
+        const Ancestor* FindAncestor(const TypeDescriptor* type) const;
+        void CollectAncestors(std::ptrdiff_t offset, bool isOffsetKnown, std::vector<Base*>& castChain, std::vector<Ancestor>& ancestors) const;
+
+        static size_t HashDescriptor(const TypeDescriptor* type);
+
+        friend void Freeze();
+        friend void Details::CompactMetadata();
+        friend class ReflectionImage;
+
     private:
         std::string m_Name;
+        TypeId m_TypeId;
         std::size_t m_Size;
+        std::size_t m_Alignment;
 
         std::vector<Base*> m_Bases;
         std::vector<Conversion*> m_Conversions;
         std::vector<Constructor*> m_Constructors;
         std::vector<DataMember*> m_DataMembers;
         std::vector<Function*> m_MemberFunctions;
+        bool m_IsCompacted = false; // The metadata above already lives in the metadata arena, moved there by Freeze() or loaded from an image.
 
         // C++ Primary Type Categories
         bool m_IsVoid;
@@ -113,6 +296,11 @@ namespace Speculo
         bool m_IsUnion;
         bool m_IsEnum;
         bool m_IsFunction;
+
+        mutable Details::PublishedTable<MemberTable> m_MemberTable;
+        mutable Details::PublishedTable<AncestorTable> m_AncestorTable;
+        mutable Details::PublishedTable<ConversionCache> m_ConversionCache;
+        mutable Details::PublishedTable<ConstructorCache> m_ConstructorCache;
     };
 
     namespace Details
@@ -131,18 +319,109 @@ namespace Speculo
         }
 
         template <typename Type>
-        TypeDescriptor*& GetTypeDescriptorPointer()
+        std::atomic<TypeDescriptor*>& GetTypeDescriptorPointer()
         {
-            static TypeDescriptor* typeDescriptorPointer = nullptr; // Single instance of type descriptor pointer per reflected type.
+            static std::atomic<TypeDescriptor*> typeDescriptorPointer { nullptr }; // Single instance of type descriptor pointer per reflected type. Published once fully set up.
             return typeDescriptorPointer;
         }
 
-        inline std::map<std::string, TypeDescriptor*>& GetTypeRegistry()
+        // Serializes registration (and descriptor creation or cache rebuilds) across threads. Recursive, as registering a member resolves its type in turn.
+        inline std::recursive_mutex& GetRegistrationMutex()
+        {
+            static std::recursive_mutex registrationMutex;
+            return registrationMutex;
+        }
+
+        // Set by Freeze(). From then on the registry and every cached table are read only, so lookups take no lock at all.
+        inline std::atomic<bool>& GetRegistrationFrozen()
+        {
+            static std::atomic<bool> isRegistrationFrozen { false };
+            return isRegistrationFrozen;
+        }
+
+        // Interned names, parameter lists and, once frozen, every DataMember, Function, Constructor, Base and Conversion.
+        // Never released, as reflection metadata has always lived for the whole program.
+        inline Arena& GetMetadataArena()
+        {
+            static Arena* metadataArena = new Arena();
+            return *metadataArena;
+        }
+
+        // Every name interned so far. Reflection images add their own names here, pointing into the mapped file.
+        inline std::unordered_set<std::string_view>& GetInternedNames()
+        {
+            static std::unordered_set<std::string_view> internedNames;
+            return internedNames;
+        }
+
+        // Returns a null terminated copy of name in the metadata arena, shared by every member registered under the same name.
+        inline std::string_view InternName(std::string_view name)
+        {
+            std::unordered_set<std::string_view>& internedNames = GetInternedNames();
+            std::lock_guard<std::recursive_mutex> registrationLock(GetRegistrationMutex());
+
+            if (auto nameIterator = internedNames.find(name); nameIterator != internedNames.end())
+            {
+                return *nameIterator;
+            }
+
+            char* internedName = static_cast<char*>(GetMetadataArena().Allocate(name.size() + 1, alignof(char)));
+            std::memcpy(internedName, name.data(), name.size());
+            internedName[name.size()] = '\0';
+
+            return *internedNames.emplace(internedName, name.size()).first;
+        }
+
+        inline TypeList InternTypeList(std::initializer_list<const TypeDescriptor*> types)
+        {
+            if (types.size() == 0)
+            {
+                return TypeList();
+            }
+
+            std::lock_guard<std::recursive_mutex> registrationLock(GetRegistrationMutex());
+
+            const TypeDescriptor** internedTypes = static_cast<const TypeDescriptor**>(GetMetadataArena().Allocate(types.size() * sizeof(const TypeDescriptor*), alignof(const TypeDescriptor*)));
+            std::copy(types.begin(), types.end(), internedTypes);
+
+            return TypeList(internedTypes, types.size());
+        }
+
+        // Returns the lock unheld once Freeze() has been called, in which case callers must register nothing: Lookups no longer lock, so any change
+        // to the registry or a descriptor would race with them.
+        inline std::unique_lock<std::recursive_mutex> LockRegistration()
+        {
+            std::unique_lock<std::recursive_mutex> registrationLock(GetRegistrationMutex());
+
+            if (GetRegistrationFrozen().load(std::memory_order_relaxed))
+            {
+                SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_REFLECTION_FROZEN, "Types must all be registered before Speculo::Freeze() is called");
+                registrationLock.unlock();
+            }
+
+            return registrationLock;
+        }
+
+        inline TypeRegistry& GetTypeRegistry()
         {
-            static std::map<std::string, TypeDescriptor*> typeRegistry;
+            static TypeRegistry typeRegistry;
             return typeRegistry;
         }
 
+        // Every descriptor created so far, in creation order.
+        inline std::vector<TypeDescriptor*>& GetTypeDescriptors()
+        {
+            static std::vector<TypeDescriptor*> typeDescriptors;
+            return typeDescriptors;
+        }
+
+        // Bumped by every registration. Cached per type tables compare against it, as adding a member to a base changes every derived table too.
+        inline std::atomic<uint64_t>& GetRegistrationEpoch()
+        {
+            static std::atomic<uint64_t> registrationEpoch { 1 };
+            return registrationEpoch;
+        }
+
         template <typename Type>
         inline constexpr auto GetTypeSize() -> typename std::enable_if<!std::is_same<RawType<Type>, void>::value, std::size_t>::type
         {
@@ -155,18 +434,38 @@ namespace Speculo
             return 0U;
         }
 
-        // Internal function template that returns a type descriptor by type.
+        template <typename Type>
+        inline constexpr auto GetTypeAlignment() -> typename std::enable_if<!std::is_same<RawType<Type>, void>::value, std::size_t>::type
+        {
+            return alignof(RawType<Type>);
+        }
+
+        template <typename Type>
+        inline constexpr auto GetTypeAlignment() -> typename std::enable_if<std::is_same<RawType<Type>, void>::value, std::size_t>::type
+        {
+            return 0U;
+        }
+
+        // Internal function template that returns a type descriptor by type. A single acquire load once the type has been seen.
         template <typename Type>
         TypeDescriptor* Resolve()
         {
-            TypeDescriptor*& typeDescriptorPointer = GetTypeDescriptorPointer<RawType<Type>>();
+            std::atomic<TypeDescriptor*>& typeDescriptorPointer = GetTypeDescriptorPointer<RawType<Type>>();
 
-            if (!typeDescriptorPointer) // Create a type descriptor if not present.
+            if (TypeDescriptor* resolvedDescriptor = typeDescriptorPointer.load(std::memory_order_acquire))
+            {
+                return resolvedDescriptor;
+            }
+
+            std::lock_guard<std::recursive_mutex> registrationLock(GetRegistrationMutex());
+
+            if (!typeDescriptorPointer.load(std::memory_order_relaxed)) // Create a type descriptor if not present.
             {
                 TypeDescriptor& typeDescriptor = GetTypeDescriptor<RawType<Type>>();
-                typeDescriptorPointer = &typeDescriptor;
+                GetTypeDescriptors().push_back(&typeDescriptor);
 
                 typeDescriptor.m_Size = GetTypeSize<Type>();
+                typeDescriptor.m_Alignment = GetTypeAlignment<Type>();
                 
                 typeDescriptor.m_IsVoid = std::is_void_v<Type>;
                 typeDescriptor.m_IsIntegral = std::is_integral_v<Type>;
@@ -180,21 +479,18 @@ namespace Speculo
                 typeDescriptor.m_IsUnion = std::is_union_v<Type>;
                 typeDescriptor.m_IsEnum = std::is_enum_v<Type>;
                 typeDescriptor.m_IsFunction = std::is_function_v<Type>;
+
+                typeDescriptorPointer.store(&typeDescriptor, std::memory_order_release);
             }
 
-            return typeDescriptorPointer;
+            return typeDescriptorPointer.load(std::memory_order_relaxed);
         }
 
         // Internal function template that returns a type descriptor by object.
         template <typename Type>
         TypeDescriptor* Resolve(Type&& object)
         {
-            if (!GetTypeDescriptorPointer<RawType<Type>>())
-            {
-                Resolve<Type>();
-            }
-
-            return GetTypeDescriptorPointer<RawType<Type>>();
+            return Resolve<Type>();
         }
     }
 }
@@ -7,79 +7,143 @@
 #include "Constructor.hpp"
 #include "Base.hpp"
 #include "Conversion.hpp"
+#include <algorithm>
 
 namespace Speculo
 {
     template <typename Type, typename ...Args>
     void TypeDescriptor::AddConstructor()
     {
+        auto registrationLock = Details::LockRegistration();
+        if (!registrationLock)
+        {
+            return;
+        }
+
         Constructor* constructor = new ConstructorImplementation<Type, Args...>();
 
         m_Constructors.push_back(constructor);
+        Details::GetRegistrationEpoch()++;
     }
 
     template <typename Type, typename ...Args>
     void TypeDescriptor::AddConstructor(Type(*constructorFunction)(Args...))
     {
+        auto registrationLock = Details::LockRegistration();
+        if (!registrationLock)
+        {
+            return;
+        }
+
         Constructor* constructor = new FreeFunctionConstructor<Type, Args...>(constructorFunction);
 
         m_Constructors.push_back(constructor);
+        Details::GetRegistrationEpoch()++;
     }
 
     template <typename B, typename T>
     void TypeDescriptor::AddBase()
     {
+        auto registrationLock = Details::LockRegistration();
+        if (!registrationLock)
+        {
+            return;
+        }
+
         Base* base = new BaseImplementation<B, T>;
 
         m_Bases.push_back(base);
+        Details::GetRegistrationEpoch()++;
     }
 
     template <typename C, typename T>
     void TypeDescriptor::AddDataMember(T C::*dataMemberPtr, const std::string& name)
     {
+        auto registrationLock = Details::LockRegistration();
+        if (!registrationLock)
+        {
+            return;
+        }
+
         DataMember* dataMember = new DataMemberPointer<C, T>(dataMemberPtr, name);
 
         m_DataMembers.push_back(dataMember);
+        Details::GetRegistrationEpoch()++;
     }
 
     template <auto Setter, auto Getter, typename Type>
     void TypeDescriptor::AddDataMember(const std::string& name)
     {
+        auto registrationLock = Details::LockRegistration();
+        if (!registrationLock)
+        {
+            return;
+        }
+
         DataMember* dataMember = new SetGetDataMember<Setter, Getter, Type>(name);
 
         m_DataMembers.push_back(dataMember);
+        Details::GetRegistrationEpoch()++;
     }
 
     template <typename Return, typename ...Args>
     void TypeDescriptor::AddMemberFunction(Return freeFunction(Args...), const std::string& name)
     {
+        auto registrationLock = Details::LockRegistration();
+        if (!registrationLock)
+        {
+            return;
+        }
+
         Function* memberFunction = new FreeFunction<Return, Args...>(freeFunction, name);
 
         m_MemberFunctions.push_back(memberFunction);
+        Details::GetRegistrationEpoch()++;
     }
 
     template <typename C, typename Return, typename ...Args>
     void TypeDescriptor::AddMemberFunction(Return(C::*memberFunction)(Args...), const std::string& name)
     {
-        Function* memberFunction = new MemberFunction<C, Return, Args...>(memberFunction, name);
+        auto registrationLock = Details::LockRegistration();
+        if (!registrationLock)
+        {
+            return;
+        }
 
-        m_MemberFunctions.push_back(memberFunction);
+        Function* function = new MemberFunction<C, Return, Args...>(memberFunction, name);
+
+        m_MemberFunctions.push_back(function);
+        Details::GetRegistrationEpoch()++;
     }
 
     template <typename C, typename Return, typename ...Args>
     void TypeDescriptor::AddMemberFunction(Return(C::* memberFunction)(Args...) const, const std::string& name)
     {
-        Function* memberFunction = new ConstMemberFunction<C, Return, Args...>(memberFunction, name);
+        auto registrationLock = Details::LockRegistration();
+        if (!registrationLock)
+        {
+            return;
+        }
 
-        m_MemberFunctions.push_back(memberFunction);
+        Function* function = new ConstMemberFunction<C, Return, Args...>(memberFunction, name);
+
+        m_MemberFunctions.push_back(function);
+        Details::GetRegistrationEpoch()++;
     }
 
     template <typename From, typename To>
     void TypeDescriptor::AddConversion()
     {
+        auto registrationLock = Details::LockRegistration();
+        if (!registrationLock)
+        {
+            return;
+        }
+
         Conversion* conversion = new ConversionImplementation<From, To>;
 
         m_Conversions.push_back(conversion);
+        Details::GetRegistrationEpoch()++;
     }
 
     inline const std::string& TypeDescriptor::GetName() const
@@ -87,7 +151,22 @@ namespace Speculo
         return m_Name;
     }
 
-    inline std::vector<Constructor*> TypeDescriptor::GetConstructors() const
+    inline TypeId TypeDescriptor::GetTypeId() const
+    {
+        return m_TypeId;
+    }
+
+    inline std::size_t TypeDescriptor::GetSize() const
+    {
+        return m_Size;
+    }
+
+    inline std::size_t TypeDescriptor::GetAlignment() const
+    {
+        return m_Alignment;
+    }
+
+    inline const std::vector<Constructor*>& TypeDescriptor::GetConstructors() const
     {
         return m_Constructors;
     }
@@ -95,18 +174,142 @@ namespace Speculo
     template <typename ...Args>
     const Constructor* TypeDescriptor::GetConstructor() const
     {
-        for (auto* constructor : m_Constructors)
+        const TypeDescriptor* argumentTypes[] = { Details::Resolve<Args>()..., nullptr }; // Trailing entry keeps the array non-empty.
+        return FindConstructorMatch(sizeof...(Args), [&](size_t index) { return argumentTypes[index]; }).m_Constructor;
+    }
+
+    inline const Constructor* TypeDescriptor::GetConstructor(const std::vector<const TypeDescriptor*>& argumentTypes) const
+    {
+        return FindConstructorMatch(argumentTypes.size(), [&](size_t index) { return argumentTypes[index]; }).m_Constructor;
+    }
+
+    inline Any TypeDescriptor::NewInstance(std::vector<Any>& args) const
+    {
+        const ConstructorMatch& match = FindConstructorMatch(args.size(), [&](size_t index) { return args[index].GetType(); });
+        if (!match.m_Constructor)
+        {
+            return Any();
+        }
+
+        if (std::none_of(match.m_Conversions.begin(), match.m_Conversions.end(), [](const TypeDescriptor* conversion) { return conversion != nullptr; }))
+        {
+            return match.m_Constructor->NewInstanceWithArguments(args.data(), args.size());
+        }
+
+        std::vector<Any> convertedArgs;
+        convertedArgs.reserve(args.size());
+
+        for (size_t i = 0; i < args.size(); i++)
+        {
+            convertedArgs.push_back(match.m_Conversions[i] ? args[i].GetType()->ConvertTo(args[i].Get(), match.m_Conversions[i]) : Any(AnyRef(args[i])));
+        }
+
+        return match.m_Constructor->NewInstanceWithArguments(convertedArgs.data(), convertedArgs.size());
+    }
+
+    template <typename GetArgumentType>
+    const TypeDescriptor::ConstructorMatch& TypeDescriptor::FindConstructorMatch(size_t argumentCount, GetArgumentType getArgumentType) const
+    {
+        ConstructorCache& constructorCache = Details::GetPublishedTable(m_ConstructorCache, [](ConstructorCache&) {}); // Starts out empty, filled in below as argument types are seen.
+
+        uint64_t argumentsHash = Details::HashName("") ^ argumentCount;
+        for (size_t i = 0; i < argumentCount; i++)
+        {
+            argumentsHash = (argumentsHash ^ reinterpret_cast<uintptr_t>(getArgumentType(i))) * 1099511628211ULL;
+        }
+
+        std::atomic<ConstructorMatch*>& bucket = constructorCache.m_Buckets[argumentsHash & (ConstructorCache::m_BucketCount - 1)];
+        auto findMatch = [&]() -> const ConstructorMatch*
         {
-            if (constructor->CanConstruct<Args...>(std::index_sequence_for<Args...>()))
+            for (const ConstructorMatch* match = bucket.load(std::memory_order_acquire); match; match = match->m_Next)
             {
-                return constructor;
+                bool isSameArguments = match->m_Hash == argumentsHash && match->m_ArgumentTypes.size() == argumentCount;
+                for (size_t i = 0; isSameArguments && i < argumentCount; i++)
+                {
+                    isSameArguments = match->m_ArgumentTypes[i] == getArgumentType(i);
+                }
+
+                if (isSameArguments)
+                {
+                    return match;
+                }
             }
+
+            return nullptr;
+        };
+
+        if (const ConstructorMatch* cachedMatch = findMatch())
+        {
+            return *cachedMatch;
         }
 
-        return nullptr;
+        std::lock_guard<std::recursive_mutex> registrationLock(Details::GetRegistrationMutex());
+        if (const ConstructorMatch* cachedMatch = findMatch()) // Another thread may have just added it.
+        {
+            return *cachedMatch;
+        }
+
+        // First time these argument types are seen: Score every overload. Lowest cost wins, and the earliest registered on ties.
+        std::unique_ptr<ConstructorMatch> newMatch = std::make_unique<ConstructorMatch>();
+        ConstructorMatch& match = *newMatch;
+        match.m_Hash = argumentsHash;
+
+        for (size_t i = 0; i < argumentCount; i++)
+        {
+            match.m_ArgumentTypes.push_back(getArgumentType(i));
+        }
+
+        size_t bestCost = SIZE_MAX;
+        for (const Constructor* constructor : m_Constructors)
+        {
+            if (constructor->GetParameterCount() != argumentCount)
+            {
+                continue;
+            }
+
+            size_t cost = 0;
+            std::vector<const TypeDescriptor*> conversions(argumentCount, nullptr);
+
+            for (size_t i = 0; i < argumentCount && cost != SIZE_MAX; i++)
+            {
+                const TypeDescriptor* argumentType = match.m_ArgumentTypes[i];
+                const TypeDescriptor* parameterType = constructor->GetParameterType(i);
+
+                if (argumentType == parameterType)
+                {
+                    continue;
+                }
+                else if (argumentType && argumentType->IsA(parameterType))
+                {
+                    cost += 1;
+                }
+                else if (argumentType && argumentType->CanConvertTo(parameterType))
+                {
+                    cost += 2 * argumentType->GetConversionPath(parameterType).size();
+                    conversions[i] = parameterType;
+                }
+                else
+                {
+                    cost = SIZE_MAX;
+                }
+            }
+
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                match.m_Constructor = constructor;
+                match.m_Conversions = std::move(conversions);
+            }
+        }
+
+        match.m_Next = bucket.load(std::memory_order_relaxed);
+        constructorCache.m_Matches.push_back(std::move(newMatch));
+        bucket.store(&match, std::memory_order_release);
+
+        return match;
     }
 
-    inline std::vector<Base*> TypeDescriptor::GetBases() const
+    inline const std::vector<Base*>& TypeDescriptor::GetBases() const
     {
         return m_Bases;
     }
@@ -116,7 +319,7 @@ namespace Speculo
     {
         for (auto base : m_Bases)
         {
-            if (base->GetType() == Details::Resolve<B>)
+            if (base->GetType() == Details::Resolve<B>())
             {
                 return base;
             }
@@ -125,79 +328,245 @@ namespace Speculo
         return nullptr;
     }
 
-    inline std::vector<DataMember*> TypeDescriptor::GetDataMembers() const
+    inline bool TypeDescriptor::IsA(const TypeDescriptor* type) const
+    {
+        return type == this || FindAncestor(type) != nullptr;
+    }
+
+    inline void* TypeDescriptor::CastTo(void* object, const TypeDescriptor* type) const
     {
-        std::vector<DataMember*> dataMembers(m_DataMembers);
+        if (type == this || !object)
+        {
+            return type == this ? object : nullptr;
+        }
 
-        for (auto* base : m_Bases) // Get members in base classes as well.
+        const Ancestor* ancestor = FindAncestor(type);
+        if (!ancestor)
         {
-            for (auto dataMember : base->GetType()->GetDataMembers())
-            {
-                dataMembers.push_back(dataMember);
-            }
+            return nullptr;
+        }
+
+        if (ancestor->m_CastChain.empty())
+        {
+            return static_cast<char*>(object) + ancestor->m_Offset;
+        }
+
+        for (Base* base : ancestor->m_CastChain) // Virtual bases can only be located through the object itself.
+        {
+            object = base->Cast(object);
         }
 
-        return dataMembers;
+        return object;
     }
 
-    inline DataMember* TypeDescriptor::GetDataMember(const std::string& name) const
+    inline size_t TypeDescriptor::HashDescriptor(const TypeDescriptor* type)
     {
-        for (auto* dataMember : m_DataMembers)
+        return static_cast<size_t>((reinterpret_cast<uintptr_t>(type) >> 4) * 11400714819323198485ULL >> 16); // Fibonacci hashing, as the low bits of a pointer carry little entropy.
+    }
+
+    inline const TypeDescriptor::Ancestor* TypeDescriptor::FindAncestor(const TypeDescriptor* type) const
+    {
+        const AncestorTable& ancestorTable = GetAncestorTable();
+        if (ancestorTable.m_Slots.empty())
         {
-            if (dataMember->GetName() == name)
-            {
-                return dataMember;
-            }
+            return nullptr;
         }
 
-        for (auto* base : m_Bases)
+        const size_t mask = ancestorTable.m_Slots.size() - 1;
+        for (size_t index = HashDescriptor(type) & mask; ancestorTable.m_Slots[index].m_Type; index = (index + 1) & mask)
         {
-            if (auto* baseDataMember = base->GetType()->GetDataMember(name))
+            if (ancestorTable.m_Slots[index].m_Type == type)
             {
-                return baseDataMember;
+                return &ancestorTable.m_Slots[index];
             }
         }
 
         return nullptr;
     }
 
-    inline std::vector<Function*> TypeDescriptor::GetMemberFunctions() const
+    inline void TypeDescriptor::CollectAncestors(std::ptrdiff_t offset, bool isOffsetKnown, std::vector<Base*>& castChain, std::vector<Ancestor>& ancestors) const
     {
-        std::vector<Function*> memberFunctions(m_MemberFunctions);
-
-        for (auto* base : m_Bases)
+        for (Base* base : m_Bases)
         {
-            for (auto memberFunction : base->GetType()->GetMemberFunctions())
+            castChain.push_back(base);
+
+            const std::ptrdiff_t baseOffset = offset + base->GetOffset();
+            const bool isBaseOffsetKnown = isOffsetKnown && !base->IsVirtual();
+
+            // Depth first, so the first path found wins if a type is reachable along several, much like the previous direct base walk.
+            if (std::none_of(ancestors.begin(), ancestors.end(), [&](const Ancestor& ancestor) { return ancestor.m_Type == base->GetType(); }))
             {
-                memberFunctions.push_back(memberFunction);
+                Ancestor ancestor;
+                ancestor.m_Type = base->GetType();
+                ancestor.m_Offset = baseOffset;
+
+                if (!isBaseOffsetKnown)
+                {
+                    ancestor.m_CastChain = castChain;
+                }
+
+                ancestors.push_back(std::move(ancestor));
             }
+
+            base->GetType()->CollectAncestors(baseOffset, isBaseOffsetKnown, castChain, ancestors);
+            castChain.pop_back();
         }
+    }
 
-        return memberFunctions;
+    inline const TypeDescriptor::AncestorTable& TypeDescriptor::GetAncestorTable() const
+    {
+        return Details::GetPublishedTable(m_AncestorTable, [this](AncestorTable& ancestorTable)
+        {
+            std::vector<Base*> castChain;
+            std::vector<Ancestor> ancestors;
+            CollectAncestors(0, true, castChain, ancestors);
+
+            if (ancestors.empty())
+            {
+                return;
+            }
+
+            size_t capacity = 4;
+            while (capacity < ancestors.size() * 2)
+            {
+                capacity *= 2;
+            }
+
+            ancestorTable.m_Slots.resize(capacity);
+            for (Ancestor& ancestor : ancestors)
+            {
+                size_t index = HashDescriptor(ancestor.m_Type) & (capacity - 1);
+                while (ancestorTable.m_Slots[index].m_Type)
+                {
+                    index = (index + 1) & (capacity - 1);
+                }
+
+                ancestorTable.m_Slots[index] = std::move(ancestor);
+            }
+        });
     }
 
-    inline const Function* TypeDescriptor::GetMemberFunction(const std::string& name) const
+    inline const TypeDescriptor::MemberTable& TypeDescriptor::GetMemberTable() const
     {
-        for (auto* memberFunction : m_MemberFunctions)
+        return Details::GetPublishedTable(m_MemberTable, [this](MemberTable& memberTable)
         {
-            if (memberFunction->GetName() == name)
+            memberTable.m_DataMembers = m_DataMembers;
+            memberTable.m_MemberFunctions = m_MemberFunctions;
+
+            for (auto* base : m_Bases) // Get members in base classes as well.
             {
-                return memberFunction;
+                const MemberTable& baseTable = base->GetType()->GetMemberTable();
+
+                memberTable.m_DataMembers.insert(memberTable.m_DataMembers.end(), baseTable.m_DataMembers.begin(), baseTable.m_DataMembers.end());
+                memberTable.m_MemberFunctions.insert(memberTable.m_MemberFunctions.end(), baseTable.m_MemberFunctions.begin(), baseTable.m_MemberFunctions.end());
             }
+
+            BuildNameIndex(memberTable.m_DataMembers, memberTable.m_DataMemberIndex);
+            BuildNameIndex(memberTable.m_MemberFunctions, memberTable.m_MemberFunctionIndex);
+        });
+    }
+
+    template <typename Table, typename BuildTable>
+    Table& Details::GetPublishedTable(PublishedTable<Table>& publishedTable, BuildTable buildTable)
+    {
+        const uint64_t registrationEpoch = Details::GetRegistrationEpoch().load(std::memory_order_acquire);
+
+        Table* currentTable = publishedTable.m_Current.load(std::memory_order_acquire);
+        if (currentTable && currentTable->m_Epoch == registrationEpoch)
+        {
+            return *currentTable;
         }
 
-        for (auto* base : m_Bases)
+        std::lock_guard<std::recursive_mutex> registrationLock(Details::GetRegistrationMutex());
+
+        currentTable = publishedTable.m_Current.load(std::memory_order_relaxed);
+        if (currentTable && currentTable->m_Epoch == registrationEpoch) // Built by another thread in the meantime.
         {
-            if (auto* memberFunction = base->GetType()->GetMemberFunction(name))
+            return *currentTable;
+        }
+
+        std::unique_ptr<Table> table = std::make_unique<Table>();
+        table->m_Epoch = registrationEpoch;
+        buildTable(*table);
+
+        return PublishTable(publishedTable, std::move(table));
+    }
+
+    template <typename Table>
+    Table& Details::PublishTable(PublishedTable<Table>& publishedTable, std::unique_ptr<Table> table)
+    {
+        Table& newTable = *table;
+
+        publishedTable.m_Builds.push_back(std::move(table));
+        publishedTable.m_Current.store(&newTable, std::memory_order_release);
+
+        return newTable;
+    }
+
+    template <typename Table>
+    void Details::ReleaseSupersededTables(PublishedTable<Table>& publishedTable)
+    {
+        const Table* currentTable = publishedTable.m_Current.load(std::memory_order_relaxed);
+
+        publishedTable.m_Builds.erase(std::remove_if(publishedTable.m_Builds.begin(), publishedTable.m_Builds.end(),
+                                      [currentTable](const std::unique_ptr<Table>& build) { return build.get() != currentTable; }), publishedTable.m_Builds.end());
+        publishedTable.m_Builds.shrink_to_fit();
+    }
+
+    template <typename Entry>
+    void TypeDescriptor::BuildNameIndex(const std::vector<Entry*>& entries, NameIndex& nameIndex)
+    {
+        nameIndex.clear();
+        nameIndex.reserve(entries.size());
+
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            nameIndex.emplace_back(Details::HashName(entries[i]->GetName()), i);
+        }
+
+        // Sorting on (hash, index) keeps entries sharing a name in table order, so derived members still shadow base members.
+        std::sort(nameIndex.begin(), nameIndex.end());
+    }
+
+    template <typename Entry>
+    Entry* TypeDescriptor::FindByName(const std::vector<Entry*>& entries, const NameIndex& nameIndex, std::string_view name)
+    {
+        const uint64_t nameHash = Details::HashName(name);
+
+        for (auto it = std::lower_bound(nameIndex.begin(), nameIndex.end(), std::make_pair(nameHash, size_t(0))); it != nameIndex.end() && it->first == nameHash; ++it)
+        {
+            if (entries[it->second]->GetName() == name)
             {
-                return memberFunction;
+                return entries[it->second];
             }
         }
 
         return nullptr;
     }
 
-    inline std::vector<Conversion*> TypeDescriptor::GetConversions() const
+    inline const std::vector<DataMember*>& TypeDescriptor::GetDataMembers() const
+    {
+        return GetMemberTable().m_DataMembers;
+    }
+
+    inline DataMember* TypeDescriptor::GetDataMember(std::string_view name) const
+    {
+        const MemberTable& memberTable = GetMemberTable();
+        return FindByName(memberTable.m_DataMembers, memberTable.m_DataMemberIndex, name);
+    }
+
+    inline const std::vector<Function*>& TypeDescriptor::GetMemberFunctions() const
+    {
+        return GetMemberTable().m_MemberFunctions;
+    }
+
+    inline const Function* TypeDescriptor::GetMemberFunction(std::string_view name) const
+    {
+        const MemberTable& memberTable = GetMemberTable();
+        return FindByName(memberTable.m_MemberFunctions, memberTable.m_MemberFunctionIndex, name);
+    }
+
+    inline const std::vector<Conversion*>& TypeDescriptor::GetConversions() const
     {
         return m_Conversions;
     }
@@ -215,6 +584,70 @@ namespace Speculo
 
         return nullptr;
     }
+
+    inline const std::vector<Conversion*>& TypeDescriptor::GetConversionPath(const TypeDescriptor* to) const
+    {
+        static const std::vector<Conversion*> noConversionPath;
+
+        const ConversionCache& conversionCache = GetConversionCache();
+        auto pathIterator = conversionCache.m_Paths.find(to);
+
+        return pathIterator != conversionCache.m_Paths.end() ? pathIterator->second : noConversionPath;
+    }
+
+    inline const TypeDescriptor::ConversionCache& TypeDescriptor::GetConversionCache() const
+    {
+        return Details::GetPublishedTable(m_ConversionCache, [this](ConversionCache& conversionCache)
+        {
+            // Breadth first, so the first path found to each type takes the fewest conversions.
+            std::unordered_map<const TypeDescriptor*, Conversion*> reachedBy { { this, nullptr } };
+            std::vector<const TypeDescriptor*> frontier { this };
+
+            for (size_t i = 0; i < frontier.size(); i++)
+            {
+                for (Conversion* conversion : frontier[i]->m_Conversions)
+                {
+                    if (reachedBy.emplace(conversion->GetToType(), conversion).second)
+                    {
+                        frontier.push_back(conversion->GetToType());
+                    }
+                }
+            }
+
+            for (size_t i = 1; i < frontier.size(); i++) // Skips this type itself.
+            {
+                std::vector<Conversion*>& conversionPath = conversionCache.m_Paths[frontier[i]];
+                for (const TypeDescriptor* type = frontier[i]; type != this; type = reachedBy[type]->GetFromType())
+                {
+                    conversionPath.push_back(reachedBy[type]);
+                }
+
+                std::reverse(conversionPath.begin(), conversionPath.end());
+            }
+        });
+    }
+
+    inline bool TypeDescriptor::CanConvertTo(const TypeDescriptor* to) const
+    {
+        return to == this || !GetConversionPath(to).empty();
+    }
+
+    inline Any TypeDescriptor::ConvertTo(const void* object, const TypeDescriptor* to) const
+    {
+        const std::vector<Conversion*>& conversionPath = GetConversionPath(to);
+        if (conversionPath.empty())
+        {
+            return Any();
+        }
+
+        Any converted = conversionPath.front()->Convert(object);
+        for (size_t i = 1; i < conversionPath.size(); i++)
+        {
+            converted = conversionPath[i]->Convert(converted.Get());
+        }
+
+        return converted;
+    }
 }
 
 
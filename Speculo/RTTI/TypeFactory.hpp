@@ -20,9 +20,15 @@ namespace Speculo
         TypeFactory& ReflectType(const std::string& name)
         {
             TypeDescriptor* typeDescriptor = Details::Resolve<Type>();
+            auto registrationLock = Details::LockRegistration();
+            if (!registrationLock)
+            {
+                return *this;
+            }
 
             typeDescriptor->m_Name = name;
-            Details::GetTypeRegistry()[name] = typeDescriptor;
+            typeDescriptor->m_TypeId = TypeId(name);
+            Details::GetTypeRegistry().Register(name, typeDescriptor);
 
             return *this;
         }
@@ -30,7 +36,7 @@ namespace Speculo
         template <typename ...Args>
         TypeFactory& AddConstructor()
         {
-            Details::Resolve<Type>()->template AddConstructor<Type, ...Args>();
+            Details::Resolve<Type>()->template AddConstructor<Type, Args...>();
 
             return *this;
         }
@@ -46,7 +52,7 @@ namespace Speculo
         template <typename Base>
         TypeFactory& AddBase()
         {
-            static_Assert(std::is_base_of<Base, Type>::value); // Base must be a base class of Type.
+            static_assert(std::is_base_of<Base, Type>::value); // Base must be a base class of Type.
 
             Details::Resolve<Type>()->template AddBase<Base, Type>();
 
@@ -78,7 +84,7 @@ namespace Speculo
         }
 
         template <typename Return, typename ...Args, typename U = Type>
-        TypeFactory& AddMemberFunction(Return(*U::*memberFunction)(Args...), const std::string& name)
+        TypeFactory& AddMemberFunction(Return(U::*memberFunction)(Args...), const std::string& name)
         {
             Details::Resolve<Type>()->AddMemberFunction(memberFunction, name);
 
@@ -105,4 +111,4 @@ namespace Speculo
     };
 }
 
-#endif TYPE_FACTORY_H
\ No newline at end of file
+#endif // TYPE_FACTORY_H
\ No newline at end of file
@@ -0,0 +1,59 @@
+#ifndef TYPE_ID_H
+#define TYPE_ID_H
+
+#include <cstdint>
+#include <string_view>
+
+namespace Speculo
+{
+    namespace Details
+    {
+        // 64-bit FNV-1a. Cheap enough for short identifiers and usable in constant expressions.
+        constexpr uint64_t HashName(std::string_view name)
+        {
+            uint64_t hash = 14695981039346656037ULL; // FNV offset basis.
+            for (const char character : name)
+            {
+                hash ^= static_cast<uint8_t>(character);
+                hash *= 1099511628211ULL;            // FNV prime.
+            }
+
+            return hash;
+        }
+    }
+
+    // A stable 64-bit identifier derived from the name a type is reflected under (FNV-1a). Identical across builds and platforms,
+    // so it can be computed at compile time from a literal and persisted in files, i.e. constexpr TypeId playerId("Player").
+    class TypeId
+    {
+    public:
+        constexpr TypeId() = default;
+        constexpr explicit TypeId(std::string_view name) : m_Value(Hash(name)) {}
+
+        static constexpr TypeId FromValue(uint64_t value)
+        {
+            TypeId typeId;
+            typeId.m_Value = value;
+
+            return typeId;
+        }
+
+        constexpr uint64_t GetValue() const { return m_Value; }
+        constexpr bool IsValid() const { return m_Value != 0; }
+
+        constexpr bool operator==(const TypeId& other) const { return m_Value == other.m_Value; }
+        constexpr bool operator!=(const TypeId& other) const { return m_Value != other.m_Value; }
+
+    private:
+        static constexpr uint64_t Hash(std::string_view name)
+        {
+            const uint64_t hash = Details::HashName(name);
+            return hash != 0 ? hash : 1; // Zero marks empty slots in the registry.
+        }
+
+    private:
+        uint64_t m_Value = 0;
+    };
+}
+
+#endif // TYPE_ID_H
\ No newline at end of file
@@ -0,0 +1,109 @@
+#ifndef TYPE_REGISTRY_H
+#define TYPE_REGISTRY_H
+
+#include <cassert>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "TypeId.hpp"
+
+namespace Speculo
+{
+    class TypeDescriptor;
+
+    // Maps reflected names to type descriptors. Open addressing with linear probing over a flat array of slots kept at most half full,
+    // so a lookup is a hash, a mask and usually a single slot comparison. Lookups never allocate.
+    class TypeRegistry
+    {
+    public:
+        void Register(std::string_view name, TypeDescriptor* typeDescriptor)
+        {
+            if ((m_Count + 1) * 2 > m_Slots.size())
+            {
+                Rehash(m_Slots.empty() ? m_InitialCapacity : m_Slots.size() * 2);
+            }
+
+            const TypeId typeId(name);
+            Slot& slot = m_Slots[FindSlot(typeId)];
+
+            if (!slot.m_TypeId.IsValid())
+            {
+                slot.m_TypeId = typeId;
+                slot.m_Name = name;
+                m_Count++;
+            }
+
+            // Two distinct names sharing a 64-bit hash would make Find(TypeId) ambiguous. Astronomically unlikely, but rename one if it ever fires.
+            assert(slot.m_Name == name && "Reflected type names collide on their TypeId.");
+            slot.m_TypeDescriptor = typeDescriptor; // Re-registering a name rebinds it, as with the previous map.
+        }
+
+        TypeDescriptor* Find(TypeId typeId) const
+        {
+            if (m_Slots.empty() || !typeId.IsValid())
+            {
+                return nullptr;
+            }
+
+            const Slot& slot = m_Slots[FindSlot(typeId)];
+            return slot.m_TypeDescriptor;
+        }
+
+        TypeDescriptor* Find(std::string_view name) const
+        {
+            if (m_Slots.empty())
+            {
+                return nullptr;
+            }
+
+            const Slot& slot = m_Slots[FindSlot(TypeId(name))];
+            return slot.m_Name == name ? slot.m_TypeDescriptor : nullptr;
+        }
+
+        size_t GetCount() const { return m_Count; }
+
+    private:
+        struct Slot
+        {
+            TypeId m_TypeId;                            // Invalid for empty slots.
+            TypeDescriptor* m_TypeDescriptor = nullptr;
+            std::string m_Name;
+        };
+
+        // Returns the slot holding typeId, or the empty slot where it would go.
+        size_t FindSlot(TypeId typeId) const
+        {
+            const size_t mask = m_Slots.size() - 1;
+            size_t index = static_cast<size_t>(typeId.GetValue()) & mask;
+
+            while (m_Slots[index].m_TypeId.IsValid() && m_Slots[index].m_TypeId != typeId)
+            {
+                index = (index + 1) & mask;
+            }
+
+            return index;
+        }
+
+        void Rehash(size_t capacity)
+        {
+            std::vector<Slot> previousSlots(capacity);
+            previousSlots.swap(m_Slots);
+
+            for (Slot& slot : previousSlots)
+            {
+                if (slot.m_TypeId.IsValid())
+                {
+                    m_Slots[FindSlot(slot.m_TypeId)] = std::move(slot);
+                }
+            }
+        }
+
+    private:
+        static constexpr size_t m_InitialCapacity = 64; // Power of two, as the probe masks rather than divides.
+
+        std::vector<Slot> m_Slots;
+        size_t m_Count = 0;
+    };
+}
+
+#endif // TYPE_REGISTRY_H
\ No newline at end of file
@@ -0,0 +1,153 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace Speculo
+{
+    // A member known at compile time. The member pointer is a template argument, so accessing through it folds down to a plain field access.
+    template <typename Class, auto MemberPointer>
+    struct StaticMember
+    {
+        using ClassType = Class;
+        using MemberType = std::remove_reference_t<decltype(std::declval<Class&>().*MemberPointer)>;
+
+        static constexpr auto m_Pointer = MemberPointer;
+        const char* m_Name;
+
+        static constexpr MemberType& Get(Class& object) { return object.*MemberPointer; }
+        static constexpr const MemberType& Get(const Class& object) { return object.*MemberPointer; }
+    };
+
+    // Selects the member tuple of exactly T. Tags of different types never convert into one another, so a derived class without
+    // a REFLECT_STATIC_BEGIN block of its own does not pick up its base's members.
+    template <typename T>
+    struct StaticTag { };
+
+    // Member tuple of a type declared with REFLECT_STATIC_BEGIN, found through argument dependent lookup.
+    template <typename T>
+    constexpr auto GetStaticMembers() -> decltype(SpeculoStaticMembers(StaticTag<T>()))
+    {
+        return SpeculoStaticMembers(StaticTag<T>());
+    }
+
+    template <typename T, typename = void>
+    struct IsStaticallyReflected : std::false_type { };
+
+    template <typename T>
+    struct IsStaticallyReflected<T, std::void_t<decltype(GetStaticMembers<T>())>> : std::true_type { };
+
+    template <typename T>
+    constexpr size_t GetStaticMemberCount()
+    {
+        return std::tuple_size<decltype(GetStaticMembers<T>())>::value;
+    }
+
+    template <typename T>
+    constexpr bool MemberEqual(const T& value, const T& otherValue);
+
+    template <typename T>
+    size_t HashMember(const T& value);
+
+    // Calls visitor(name, member) for every member of object, in declaration order. Expands to one direct call per member with no loop or lookup left behind.
+    template <typename T, typename Visitor>
+    constexpr void ForEachMember(T& object, Visitor&& visitor)
+    {
+        constexpr auto members = GetStaticMembers<std::remove_cv_t<T>>();
+
+        std::apply([&](const auto&... member)
+        {
+            (visitor(member.m_Name, member.Get(object)), ...);
+        }, members);
+    }
+
+    // Calls visitor(name, member, otherMember) for every member of two objects of the same type, i.e. for comparisons.
+    template <typename T, typename Visitor>
+    constexpr void ForEachMember(T& object, T& otherObject, Visitor&& visitor)
+    {
+        constexpr auto members = GetStaticMembers<std::remove_cv_t<T>>();
+
+        std::apply([&](const auto&... member)
+        {
+            (visitor(member.m_Name, member.Get(object), member.Get(otherObject)), ...);
+        }, members);
+    }
+
+    // Member by member equality, stopping at the first difference. Members that are statically reflected themselves are compared the same way, the rest with ==.
+    template <typename T>
+    constexpr bool MembersEqual(const T& object, const T& otherObject)
+    {
+        constexpr auto members = GetStaticMembers<T>();
+
+        return std::apply([&](const auto&... member)
+        {
+            return (MemberEqual(member.Get(object), member.Get(otherObject)) && ...);
+        }, members);
+    }
+
+    template <typename T>
+    constexpr bool MemberEqual(const T& value, const T& otherValue)
+    {
+        if constexpr (IsStaticallyReflected<T>::value)
+        {
+            return MembersEqual(value, otherValue);
+        }
+        else
+        {
+            return value == otherValue;
+        }
+    }
+
+    // Combines the hashes of every member, recursing into statically reflected members and using std::hash for the rest.
+    template <typename T>
+    size_t HashMembers(const T& object)
+    {
+        size_t hash = 0;
+        ForEachMember(object, [&hash](const char*, const auto& member)
+        {
+            hash ^= HashMember(member) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+        });
+
+        return hash;
+    }
+
+    template <typename T>
+    size_t HashMember(const T& value)
+    {
+        if constexpr (IsStaticallyReflected<T>::value)
+        {
+            return HashMembers(value);
+        }
+        else
+        {
+            return std::hash<T>()(value);
+        }
+    }
+
+// Compile time counterpart to REFLECT_STRUCT_BEGIN/MEMBER/END. Goes inside the class body, so private members can be listed too:
+//
+//     struct Vector3
+//     {
+//         float x, y, z;
+//
+//         REFLECT_STATIC_BEGIN(Vector3)
+//             REFLECT_STATIC_MEMBER(x)
+//             REFLECT_STATIC_MEMBER(y)
+//             REFLECT_STATIC_MEMBER(z)
+//         REFLECT_STATIC_END()
+//     };
+#define REFLECT_STATIC_BEGIN(type) \
+    friend constexpr auto SpeculoStaticMembers(Speculo::StaticTag<type>) \
+    {   \
+        using T [[maybe_unused]] = type; \
+        return std::tuple_cat(
+
+#define REFLECT_STATIC_MEMBER(name) \
+            std::make_tuple(Speculo::StaticMember<T, &T::name>{ #name }),
+
+#define REFLECT_STATIC_END() \
+            std::tuple<>()); \
+    }
+}
\ No newline at end of file
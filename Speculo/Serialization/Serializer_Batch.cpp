@@ -0,0 +1,161 @@
+#include "SpeculoPCH.h"
+#include "Serializer_Batch.h"
+#include "Core/ThreadPool.h"
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+
+namespace Speculo
+{
+    Serializer_Batch::Serializer_Batch(uint32_t threadCount) : m_ThreadCount(threadCount)
+    {
+
+    }
+
+    void Serializer_Batch::AddTextFile(const std::string& filePath, const std::string& fileType, std::function<void(Serializer_Text&)> callback)
+    {
+        Batch_Entry& entry = m_Entries.emplace_back();
+        entry.m_FilePath = FileSystem::ValidateAndAppendFileExtension(filePath, ".yml");
+        entry.m_FileType = fileType;
+        entry.m_TextCallback = std::move(callback);
+    }
+
+    void Serializer_Batch::AddBinaryFile(const std::string& filePath, const std::string& fileType, std::function<void(Serializer_Binary&)> callback)
+    {
+        Batch_Entry& entry = m_Entries.emplace_back();
+        entry.m_FilePath = FileSystem::ValidateAndAppendFileExtension(filePath, ".dat");
+        entry.m_FileType = fileType;
+        entry.m_BinaryCallback = std::move(callback);
+    }
+
+    void Serializer_Batch::Load(Serializer_Delivery_Order deliveryOrder)
+    {
+        if (m_Entries.empty())
+        {
+            return;
+        }
+
+        uint32_t threadCount = m_ThreadCount == 0 ? std::thread::hardware_concurrency() : m_ThreadCount;
+        threadCount = std::clamp<uint32_t>(threadCount, 1, static_cast<uint32_t>(m_Entries.size())); // No point spinning up more workers than files.
+
+        std::vector<std::string> workerBuffers(threadCount);
+
+        std::mutex completionMutex;
+        std::condition_variable entryCompleted;
+        std::vector<size_t> completionOrder;
+        completionOrder.reserve(m_Entries.size());
+
+        ThreadPool threadPool(threadCount); // Declared last so that, should a callback throw, its workers are joined before anything they touch goes away.
+
+        for (size_t entryIndex = 0; entryIndex < m_Entries.size(); entryIndex++)
+        {
+            threadPool.Submit([&, entryIndex](uint32_t workerIndex)
+            {
+                Batch_Entry& entry = m_Entries[entryIndex];
+                try
+                {
+                    LoadEntry(entry, workerBuffers[workerIndex]);
+                }
+                catch (const std::exception& exception)
+                {
+                    SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_FAILURE, entry.m_FilePath + ": " + exception.what());
+                    entry.m_TextResult.reset(); // Delivered as a failed load, i.e. skipped, so the loop below never waits on it forever.
+                    entry.m_BinaryResult.reset();
+                }
+                catch (...)
+                {
+                    SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_FAILURE, entry.m_FilePath);
+                    entry.m_TextResult.reset();
+                    entry.m_BinaryResult.reset();
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(completionMutex);
+                    m_Entries[entryIndex].m_IsLoaded = true;
+                    completionOrder.push_back(entryIndex);
+                }
+
+                entryCompleted.notify_one();
+            });
+        }
+
+        // Deliver on the calling thread so callbacks never need to be thread-safe.
+        for (size_t deliveredCount = 0; deliveredCount < m_Entries.size(); deliveredCount++)
+        {
+            size_t entryIndex = 0;
+
+            {
+                std::unique_lock<std::mutex> lock(completionMutex);
+
+                if (deliveryOrder == Serializer_Delivery_Order::Submission)
+                {
+                    entryIndex = deliveredCount;
+                    entryCompleted.wait(lock, [&]() { return m_Entries[entryIndex].m_IsLoaded; });
+                }
+                else
+                {
+                    entryCompleted.wait(lock, [&]() { return completionOrder.size() > deliveredCount; });
+                    entryIndex = completionOrder[deliveredCount];
+                }
+            }
+
+            DeliverEntry(m_Entries[entryIndex]);
+        }
+
+        threadPool.Wait();
+        m_Entries.clear();
+    }
+
+    void Serializer_Batch::LoadEntry(Batch_Entry& entry, std::string& workerBuffer)
+    {
+        if (entry.m_TextCallback)
+        {
+            // The parsed node tree owns its own copy of every scalar, so the raw bytes can live in the worker's reusable buffer.
+            if (!FileSystem::ReadFileContents(entry.m_FilePath, workerBuffer))
+            {
+                SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_FILESYSTEM_FILE_NOT_FOUND, entry.m_FilePath);
+                return;
+            }
+
+            entry.m_TextResult = std::make_unique<Serializer_Text>(entry.m_FilePath, entry.m_FileType, workerBuffer);
+        }
+        else if (entry.m_BinaryCallback)
+        {
+            // Binary deserializers decode lazily out of their buffer, so they need to own it.
+            std::string fileContents;
+            if (!FileSystem::ReadFileContents(entry.m_FilePath, fileContents))
+            {
+                SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_FILESYSTEM_FILE_NOT_FOUND, entry.m_FilePath);
+                return;
+            }
+
+            entry.m_BinaryResult = std::make_unique<Serializer_Binary>(entry.m_FilePath, entry.m_FileType, std::move(fileContents));
+        }
+    }
+
+    void Serializer_Batch::DeliverEntry(Batch_Entry& entry)
+    {
+        if (entry.m_TextResult && entry.m_TextResult->IsStreamOpen())
+        {
+            entry.m_TextCallback(*entry.m_TextResult);
+
+            if (entry.m_TextResult->IsStreamOpen())
+            {
+                entry.m_TextResult->EndDeserialization();
+            }
+        }
+        else if (entry.m_BinaryResult && entry.m_BinaryResult->IsStreamOpen())
+        {
+            entry.m_BinaryCallback(*entry.m_BinaryResult);
+
+            if (entry.m_BinaryResult->IsStreamOpen())
+            {
+                entry.m_BinaryResult->EndDeserialization();
+            }
+        }
+
+        // Release the document as soon as it has been consumed rather than holding every file until the batch ends.
+        entry.m_TextResult.reset();
+        entry.m_BinaryResult.reset();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Serializer_Text.h"
+#include "Serializer_Binary.h"
+
+namespace Speculo
+{
+    enum class Serializer_Delivery_Order
+    {
+        Submission, // Callbacks fire in the order files were added, regardless of which worker finished first.
+        Completion  // Callbacks fire as soon as each file is ready.
+    };
+
+    // Loads many independent files at once. File reads, YAML parsing and binary buffering run on a pool of worker threads,
+    // while every callback is invoked on the thread calling Load() with a fully opened deserializer.
+    //
+    // Each worker keeps its own read buffer which is reused from file to file, so workers never contend on the allocator for raw file bytes.
+    class Serializer_Batch
+    {
+    public:
+        explicit Serializer_Batch(uint32_t threadCount = 0); // 0 uses every hardware thread available.
+
+        void AddTextFile(const std::string& filePath, const std::string& fileType, std::function<void(Serializer_Text&)> callback);
+        void AddBinaryFile(const std::string& filePath, const std::string& fileType, std::function<void(Serializer_Binary&)> callback);
+
+        // Blocks until every added file has been loaded and delivered. Files that fail to open are reported and skipped.
+        void Load(Serializer_Delivery_Order deliveryOrder = Serializer_Delivery_Order::Submission);
+
+        size_t GetFileCount() const { return m_Entries.size(); }
+
+    private:
+        struct Batch_Entry
+        {
+            std::string m_FilePath;
+            std::string m_FileType;
+
+            std::function<void(Serializer_Text&)> m_TextCallback;
+            std::function<void(Serializer_Binary&)> m_BinaryCallback;
+
+            std::unique_ptr<Serializer_Text> m_TextResult;
+            std::unique_ptr<Serializer_Binary> m_BinaryResult;
+            bool m_IsLoaded = false;
+        };
+
+        void LoadEntry(Batch_Entry& entry, std::string& workerBuffer);
+        void DeliverEntry(Batch_Entry& entry);
+
+    private:
+        uint32_t m_ThreadCount = 0;
+        std::vector<Batch_Entry> m_Entries;
+    };
+}
\ No newline at end of file
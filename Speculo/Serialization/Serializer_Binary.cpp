@@ -28,6 +28,13 @@ namespace Speculo
         }
     }
 
+    Serializer_Binary::Serializer_Binary(const std::string& filePath, const std::string& fileType, std::string&& fileContents) noexcept
+                                       : Serializer_Core(Serializer_Operation_Type::Deserialization, Speculo::FileSystem::ValidateAndAppendFileExtension(filePath, ".dat"), fileType),
+                                         m_InputBuffer(std::move(fileContents))
+    {
+        OpenBuffer();
+    }
+
     Serializer_Binary::~Serializer_Binary()
     {
         if (m_IsStreamOpen)
@@ -46,7 +53,7 @@ namespace Speculo
 
     void Serializer_Binary::BeginSerialization()
     {
-        int iosFlags = std::ios::binary | std::ios::out;
+        std::ios::openmode iosFlags = std::ios::binary | std::ios::out;
         m_OutputStream.open(m_FilePath, iosFlags); // Creates file if it does not exist.
 
         if (m_OutputStream.fail())
@@ -66,15 +73,18 @@ namespace Speculo
 
     void Serializer_Binary::BeginDeserialization()
     {
-        int iosFlags = std::ios::binary | std::ios::in;
-        m_InputStream.open(m_FilePath, iosFlags);
-
-        if (m_InputStream.fail())
+        if (!FileSystem::ReadFileContents(m_FilePath, m_InputBuffer))
         {
             SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_FAILURE, m_FilePath);
             return;
         }
 
+        OpenBuffer();
+    }
+
+    void Serializer_Binary::OpenBuffer()
+    {
+        m_InputOffset = 0;
         m_IsStreamOpen = true;
 
         ValidateMetadata();
@@ -101,8 +111,15 @@ namespace Speculo
         {
             uint32_t stringSize = 0;
             DeserializeProperty(&stringSize);
-            value->resize(stringSize);
-            m_InputStream.read(const_cast<char*>(value->c_str()), stringSize);
+
+            if (m_InputOffset + stringSize > m_InputBuffer.size())
+            {
+                SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_FAILURE, std::string("Read past the end of file: ") + m_FilePath);
+                return;
+            }
+
+            value->assign(m_InputBuffer.data() + m_InputOffset, stringSize);
+            m_InputOffset += stringSize;
         }
         else
         {
@@ -113,30 +130,83 @@ namespace Speculo
 
     bool Serializer_Binary::ValidateMetadata()
     {
-        if (DeserializePropertyAs<std::string>() != m_FileType)
+        Serializer_Metadata metadata;
+        DeserializeProperty(&metadata.m_FileType);
+        DeserializeProperty(&metadata.m_Version_Major);
+        DeserializeProperty(&metadata.m_Version_Minor);
+        DeserializeProperty(&metadata.m_Version_Revision);
+
+        return CheckMetadata(metadata);
+    }
+
+    bool Serializer_Binary::PeekMetadata(const std::string& filePath, Serializer_Metadata& metadata)
+    {
+        std::ifstream inputStream(FileSystem::ValidateAndAppendFileExtension(filePath, ".dat"), std::ios::binary);
+        if (inputStream.fail())
         {
-            SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_TYPE_MISMATCH, m_FilePath);
             return false;
         }
-        
-        if (DeserializePropertyAs<int>() != m_Version_Major)
+
+        uint32_t typeSize = 0;
+        inputStream.read(reinterpret_cast<char*>(&typeSize), sizeof(typeSize));
+
+        if (inputStream.fail() || typeSize > m_MaximumPeekTypeSize) // Most likely not a file of ours. Don't go allocating whatever the first 4 bytes say.
         {
-            SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_VERSION_MAJOR_MISMATCH, m_FilePath);
             return false;
         }
 
-        if (DeserializePropertyAs<int>() != m_Version_Minor)
+        metadata.m_FileType.resize(typeSize);
+        inputStream.read(metadata.m_FileType.data(), typeSize);
+        inputStream.read(reinterpret_cast<char*>(&metadata.m_Version_Major), sizeof(metadata.m_Version_Major));
+        inputStream.read(reinterpret_cast<char*>(&metadata.m_Version_Minor), sizeof(metadata.m_Version_Minor));
+        inputStream.read(reinterpret_cast<char*>(&metadata.m_Version_Revision), sizeof(metadata.m_Version_Revision));
+
+        return !inputStream.fail();
+    }
+
+    SpeculoResult Serializer_Binary::PatchProperty(const std::string& filePath, size_t propertyOffset, const std::string& value)
+    {
+        const std::string binaryPath = FileSystem::ValidateAndAppendFileExtension(filePath, ".dat");
+
+        uint32_t stringSize = 0;
         {
-            SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_VERSION_MINOR_MISMATCH, m_FilePath);
-            return false;
+            std::ifstream inputStream(binaryPath, std::ios::binary);
+            inputStream.seekg(static_cast<std::streamoff>(propertyOffset));
+            inputStream.read(reinterpret_cast<char*>(&stringSize), sizeof(stringSize));
+
+            if (inputStream.fail())
+            {
+                SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_FAILURE, std::string("Read past the end of file: ") + binaryPath);
+                return SpeculoResult::SPECULO_ERROR_DESERIALIZATION_FAILURE;
+            }
+        }
+
+        // Laid out exactly like SerializeProperty(const std::string&) does.
+        const uint32_t patchedSize = static_cast<uint32_t>(value.size());
+        std::string patchedBytes(sizeof(patchedSize) + value.size(), '\0');
+        std::memcpy(patchedBytes.data(), &patchedSize, sizeof(patchedSize));
+        std::memcpy(patchedBytes.data() + sizeof(patchedSize), value.data(), value.size());
+
+        return PatchBytes(binaryPath, propertyOffset, sizeof(stringSize) + stringSize, patchedBytes.data(), patchedBytes.size());
+    }
+
+    SpeculoResult Serializer_Binary::PatchBytes(const std::string& filePath, size_t offset, size_t replacedSize, const void* data, size_t dataSize)
+    {
+        const std::string binaryPath = FileSystem::ValidateAndAppendFileExtension(filePath, ".dat");
+
+        if (!FileSystem::ValidateFileExistence(binaryPath))
+        {
+            SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_FILESYSTEM_FILE_NOT_FOUND, binaryPath);
+            return SpeculoResult::SPECULO_ERROR_FILESYSTEM_FILE_NOT_FOUND;
         }
 
-        if (DeserializePropertyAs<int>() != m_Version_Revision)
+        if (!FileSystem::SpliceFileContents(binaryPath, offset, replacedSize, data, dataSize))
         {
-            SPECULO_THROW_WARNING(SpeculoResult::SPECULO_WARNING_VERSION_REVISION_MISMATCH, m_FilePath);
+            SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_SERIALIZATION_FAILURE, binaryPath);
+            return SpeculoResult::SPECULO_ERROR_SERIALIZATION_FAILURE;
         }
 
-        return true;
+        return SpeculoResult::SPECULO_SUCCESS;
     }
 
     void Serializer_Binary::EndSerialization()
@@ -158,8 +228,9 @@ namespace Speculo
     {
         if (m_IsStreamOpen)
         {
-            m_InputStream.clear();
-            m_InputStream.close();
+            m_InputBuffer.clear();
+            m_InputBuffer.shrink_to_fit();
+            m_InputOffset = 0;
             m_IsStreamOpen = false;
         }
         else
@@ -1,5 +1,6 @@
 #pragma once
 #include "Serializer_Core.h"
+#include <cstring>
 #include <fstream>
 
 namespace Speculo
@@ -13,6 +14,9 @@ namespace Speculo
         ~Serializer_Binary();
         Serializer_Binary(Serializer_Operation_Type operationType, const std::string& filePath, const std::string& fileType) noexcept;
 
+        // Deserializes from file contents already read into memory. The file path is only kept around for error reporting.
+        Serializer_Binary(const std::string& filePath, const std::string& fileType, std::string&& fileContents) noexcept;
+
         template <typename T, typename = typename std::enable_if<!std::is_same<T, std::string>::value>::type>
         void SerializeProperty(T value)
         {
@@ -34,7 +38,14 @@ namespace Speculo
         {
             if (m_IsStreamOpen)
             {
-                m_InputStream.read(reinterpret_cast<char*>(value), sizeof(T));
+                if (m_InputOffset + sizeof(T) > m_InputBuffer.size())
+                {
+                    SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_FAILURE, std::string("Read past the end of file: ") + m_FilePath);
+                    return;
+                }
+
+                std::memcpy(value, m_InputBuffer.data() + m_InputOffset, sizeof(T));
+                m_InputOffset += sizeof(T);
             }
             else
             {
@@ -56,14 +67,44 @@ namespace Speculo
         virtual void EndSerialization() override;
         virtual void EndDeserialization() override;
 
+        bool IsStreamOpen() const { return m_IsStreamOpen; }
+
+        // Binary files are positional rather than keyed, so properties are patched by their byte offset within the file. Offsets are
+        // recorded right before serializing or deserializing the property in question, through GetWriteOffset() or GetReadOffset().
+        size_t GetWriteOffset() { return static_cast<size_t>(m_OutputStream.tellp()); }
+        size_t GetReadOffset() const { return m_InputOffset; }
+
+        // Overwrites a fixed size property in place. The caller is responsible for T matching the type originally serialized at that offset.
+        template <typename T, typename = typename std::enable_if<!std::is_same<T, std::string>::value>::type>
+        static SpeculoResult PatchProperty(const std::string& filePath, size_t propertyOffset, T value)
+        {
+            return PatchBytes(filePath, propertyOffset, sizeof(T), &value, sizeof(T));
+        }
+
+        // Strings are rewritten in place if their length is unchanged, and spliced in otherwise.
+        static SpeculoResult PatchProperty(const std::string& filePath, size_t propertyOffset, const std::string& value);
+
+        // Reads only the metadata header at the start of the file (a few dozen bytes) without opening it for deserialization.
+        // Never reports errors itself, as it is meant to be run over large numbers of files which may not even be ours.
+        static bool PeekMetadata(const std::string& filePath, Serializer_Metadata& metadata);
+
     private:
         virtual void BeginSerialization() override;
         virtual void BeginDeserialization() override;
         virtual bool ValidateMetadata() override;
 
+        void OpenBuffer();
+        static SpeculoResult PatchBytes(const std::string& filePath, size_t offset, size_t replacedSize, const void* data, size_t dataSize);
+
     private:
+        static constexpr uint32_t m_MaximumPeekTypeSize = 1024;
+
         std::ofstream m_OutputStream;
-        std::ifstream m_InputStream;
+
+        // Deserialization reads the whole file up front and decodes straight out of memory.
+        std::string m_InputBuffer;
+        size_t m_InputOffset = 0;
+
         bool m_IsStreamOpen = false;
     };
 }
\ No newline at end of file
@@ -0,0 +1,139 @@
+#include "SpeculoPCH.h"
+#include "Serializer_Catalog.h"
+#include "Serializer_Text.h"
+#include "Serializer_Binary.h"
+#include "Core/ThreadPool.h"
+#include <algorithm>
+#include <filesystem>
+
+namespace Speculo
+{
+    namespace
+    {
+        template <typename Directory_Iterator>
+        void CollectFiles(const std::string& directoryPath, std::vector<Serializer_Catalog_Entry>& candidates)
+        {
+            std::error_code errorCode;
+            for (const std::filesystem::directory_entry& directoryEntry : Directory_Iterator(directoryPath, std::filesystem::directory_options::skip_permission_denied, errorCode))
+            {
+                if (!directoryEntry.is_regular_file(errorCode))
+                {
+                    continue;
+                }
+
+                const std::filesystem::path& filePath = directoryEntry.path();
+                const std::filesystem::path fileExtension = filePath.extension();
+
+                if (fileExtension == ".yml" || fileExtension == ".dat")
+                {
+                    Serializer_Catalog_Entry& candidate = candidates.emplace_back();
+                    candidate.m_FilePath = filePath.generic_string();
+                    candidate.m_Format = fileExtension == ".yml" ? Serializer_Format::Text : Serializer_Format::Binary;
+                }
+            }
+        }
+    }
+
+    Serializer_Catalog::Serializer_Catalog(uint32_t threadCount) : m_ThreadCount(threadCount)
+    {
+
+    }
+
+    bool Serializer_Catalog::ScanDirectory(const std::string& directoryPath, bool isRecursive)
+    {
+        if (!std::filesystem::is_directory(directoryPath))
+        {
+            SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_FILESYSTEM_DIRECTORY_NOT_FOUND, directoryPath);
+            return false;
+        }
+
+        std::vector<Serializer_Catalog_Entry> candidates;
+        if (isRecursive)
+        {
+            CollectFiles<std::filesystem::recursive_directory_iterator>(directoryPath, candidates);
+        }
+        else
+        {
+            CollectFiles<std::filesystem::directory_iterator>(directoryPath, candidates);
+        }
+
+        if (candidates.empty())
+        {
+            return true;
+        }
+
+        // Each job peeks a contiguous chunk and writes straight into its own slots, so no locking is needed.
+        std::vector<uint8_t> isPeeked(candidates.size(), false);
+        const size_t jobCount = (candidates.size() + m_FilesPerJob - 1) / m_FilesPerJob;
+
+        uint32_t threadCount = m_ThreadCount == 0 ? std::thread::hardware_concurrency() : m_ThreadCount;
+        threadCount = std::clamp<uint32_t>(threadCount, 1, static_cast<uint32_t>(std::min<size_t>(jobCount, UINT32_MAX)));
+
+        ThreadPool threadPool(threadCount);
+        for (size_t jobIndex = 0; jobIndex < jobCount; jobIndex++)
+        {
+            threadPool.Submit([&, jobIndex](uint32_t)
+            {
+                const size_t chunkEnd = std::min(candidates.size(), (jobIndex + 1) * m_FilesPerJob);
+                for (size_t candidateIndex = jobIndex * m_FilesPerJob; candidateIndex < chunkEnd; candidateIndex++)
+                {
+                    Serializer_Catalog_Entry& candidate = candidates[candidateIndex];
+                    isPeeked[candidateIndex] = candidate.m_Format == Serializer_Format::Text ? Serializer_Text::PeekMetadata(candidate.m_FilePath, candidate.m_Metadata)
+                                                                                             : Serializer_Binary::PeekMetadata(candidate.m_FilePath, candidate.m_Metadata);
+                }
+            });
+        }
+
+        threadPool.Wait();
+
+        m_Entries.reserve(m_Entries.size() + candidates.size());
+        for (size_t candidateIndex = 0; candidateIndex < candidates.size(); candidateIndex++)
+        {
+            if (isPeeked[candidateIndex])
+            {
+                m_Entries.push_back(std::move(candidates[candidateIndex]));
+            }
+            else
+            {
+                m_SkippedFileCount++;
+            }
+        }
+
+        return true;
+    }
+
+    void Serializer_Catalog::Clear()
+    {
+        m_Entries.clear();
+        m_SkippedFileCount = 0;
+    }
+
+    std::vector<const Serializer_Catalog_Entry*> Serializer_Catalog::FindFilesOfType(const std::string& fileType) const
+    {
+        std::vector<const Serializer_Catalog_Entry*> matchingEntries;
+        for (const Serializer_Catalog_Entry& entry : m_Entries)
+        {
+            if (entry.m_Metadata.m_FileType == fileType)
+            {
+                matchingEntries.push_back(&entry);
+            }
+        }
+
+        return matchingEntries;
+    }
+
+    std::vector<const Serializer_Catalog_Entry*> Serializer_Catalog::FindCompatibleFiles(const std::string& fileType) const
+    {
+        std::vector<const Serializer_Catalog_Entry*> matchingEntries;
+        for (const Serializer_Catalog_Entry& entry : m_Entries)
+        {
+            const SpeculoResult result = Serializer_Core::CompareMetadata(entry.m_Metadata, fileType);
+            if (result == SpeculoResult::SPECULO_SUCCESS || result == SpeculoResult::SPECULO_WARNING_VERSION_REVISION_MISMATCH)
+            {
+                matchingEntries.push_back(&entry);
+            }
+        }
+
+        return matchingEntries;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Serializer_Core.h"
+
+namespace Speculo
+{
+    enum class Serializer_Format
+    {
+        Text,  // .yml
+        Binary // .dat
+    };
+
+    struct Serializer_Catalog_Entry
+    {
+        std::string m_FilePath;
+        Serializer_Format m_Format = Serializer_Format::Text;
+        Serializer_Metadata m_Metadata;
+    };
+
+    // Indexes the type and version of every serialized file within a directory by peeking at their metadata only, without ever parsing their data.
+    // Files are peeked in parallel, in chunks, on a pool of worker threads.
+    class Serializer_Catalog
+    {
+    public:
+        explicit Serializer_Catalog(uint32_t threadCount = 0); // 0 uses every hardware thread available.
+
+        // Adds every .yml and .dat file found to the catalog. Files whose metadata cannot be read are skipped and counted rather than reported one by one.
+        bool ScanDirectory(const std::string& directoryPath, bool isRecursive = true);
+        void Clear();
+
+        std::vector<const Serializer_Catalog_Entry*> FindFilesOfType(const std::string& fileType) const;
+
+        // Same as above, but only files that would deserialize without version errors. Revision mismatches are still included.
+        std::vector<const Serializer_Catalog_Entry*> FindCompatibleFiles(const std::string& fileType) const;
+
+        const std::vector<Serializer_Catalog_Entry>& GetEntries() const { return m_Entries; }
+        size_t GetSkippedFileCount() const { return m_SkippedFileCount; }
+
+    private:
+        static constexpr size_t m_FilesPerJob = 64; // Keeps queue traffic negligible next to the file reads themselves.
+
+        uint32_t m_ThreadCount = 0;
+        std::vector<Serializer_Catalog_Entry> m_Entries;
+        size_t m_SkippedFileCount = 0;
+    };
+}
\ No newline at end of file
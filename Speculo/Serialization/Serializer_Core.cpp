@@ -0,0 +1,47 @@
+#include "SpeculoPCH.h"
+#include "Serializer_Core.h"
+
+namespace Speculo
+{
+    SpeculoResult Serializer_Core::CompareMetadata(const Serializer_Metadata& metadata, const std::string& fileType)
+    {
+        if (metadata.m_FileType != fileType)
+        {
+            return SpeculoResult::SPECULO_ERROR_DESERIALIZATION_TYPE_MISMATCH;
+        }
+
+        if (metadata.m_Version_Major != SPECULO_VERSION_MAJOR)
+        {
+            return SpeculoResult::SPECULO_ERROR_VERSION_MAJOR_MISMATCH;
+        }
+
+        if (metadata.m_Version_Minor != SPECULO_VERSION_MINOR)
+        {
+            return SpeculoResult::SPECULO_ERROR_VERSION_MINOR_MISMATCH;
+        }
+
+        if (metadata.m_Version_Revision != SPECULO_VERSION_REVISION)
+        {
+            return SpeculoResult::SPECULO_WARNING_VERSION_REVISION_MISMATCH;
+        }
+
+        return SpeculoResult::SPECULO_SUCCESS;
+    }
+
+    bool Serializer_Core::CheckMetadata(const Serializer_Metadata& metadata) const
+    {
+        const SpeculoResult result = CompareMetadata(metadata, m_FileType);
+
+        if (result == SpeculoResult::SPECULO_WARNING_VERSION_REVISION_MISMATCH)
+        {
+            SPECULO_THROW_WARNING(result, m_FilePath);
+        }
+        else if (result != SpeculoResult::SPECULO_SUCCESS)
+        {
+            SPECULO_THROW_ERROR(result, m_FilePath);
+            return false;
+        }
+
+        return true;
+    }
+}
\ No newline at end of file
@@ -11,8 +11,22 @@ namespace Speculo
         Unknown
     };
 
+    // The header written at the start of every file, ahead of any data.
+    struct Serializer_Metadata
+    {
+        std::string m_FileType = "";
+        int m_Version_Major = 0;
+        int m_Version_Minor = 0;
+        int m_Version_Revision = 0;
+    };
+
     class Serializer_Core
     {
+    public:
+        // Compares a file's metadata against the expected file type and the running Speculo version. Returns SPECULO_SUCCESS,
+        // the first mismatch error encountered, or SPECULO_WARNING_VERSION_REVISION_MISMATCH if only the revision differs.
+        static SpeculoResult CompareMetadata(const Serializer_Metadata& metadata, const std::string& fileType);
+
     protected:
         Serializer_Core(Serializer_Operation_Type operationType, const std::string& filePath, const std::string& fileType) : 
                         m_FilePath(filePath), m_OperationType(operationType), m_FileType(fileType),
@@ -25,6 +39,9 @@ namespace Speculo
         virtual void EndDeserialization() = 0;
         virtual bool ValidateMetadata() = 0;
 
+        // Reports the outcome of CompareMetadata for this file. Returns false on errors.
+        bool CheckMetadata(const Serializer_Metadata& metadata) const;
+
     protected:
         Serializer_Operation_Type m_OperationType = Serializer_Operation_Type::Unknown;
         const std::string m_FilePath = "";
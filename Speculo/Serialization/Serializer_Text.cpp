@@ -1,13 +1,18 @@
 #include "SpeculoPCH.h"
 #include "Serializer_Text.h"
+#include "Serializer_Text_Scanner.h"
+#include "Serializer_Text_Base64.h"
+#include "Core/ThreadPool.h"
+#include <algorithm>
 #include <cassert>
+#include <filesystem>
 #include <fstream>
 
 // Serialization files are split explictly into two sections of data: Metadata (Versioning) and Data (Contents).
 namespace Speculo
 {
-    Serializer_Text::Serializer_Text(Serializer_Operation_Type operationType, const std::string& filePath, const std::string& fileType) noexcept
-                                   : Serializer_Core(operationType, Speculo::FileSystem::ValidateAndAppendFileExtension(filePath, ".yml"), fileType)
+    Serializer_Text::Serializer_Text(Serializer_Operation_Type operationType, const std::string& filePath, const std::string& fileType, uint32_t flags) noexcept
+                                   : Serializer_Core(operationType, Speculo::FileSystem::ValidateAndAppendFileExtension(filePath, ".yml"), fileType), m_Flags(flags)
     {
         if (operationType == Serializer_Operation_Type::Serialization)
         {
@@ -31,6 +36,12 @@ namespace Speculo
         }
     }
 
+    Serializer_Text::Serializer_Text(const std::string& filePath, const std::string& fileType, const std::string& fileContents, uint32_t flags) noexcept
+                                   : Serializer_Core(Serializer_Operation_Type::Deserialization, Speculo::FileSystem::ValidateAndAppendFileExtension(filePath, ".yml"), fileType), m_Flags(flags)
+    {
+        BeginDeserialization(fileContents);
+    }
+
     Serializer_Text::~Serializer_Text()
     {
         if (m_IsStreamOpen)
@@ -49,8 +60,41 @@ namespace Speculo
 
     void Serializer_Text::BeginSerialization()
     {
+        auto installOutputBuffer = [this]()
+        {
+            m_OutputBuffer = std::make_unique<char[]>(m_OutputBufferSize);
+            if (!m_OutputStream.rdbuf()->pubsetbuf(m_OutputBuffer.get(), m_OutputBufferSize))
+            {
+                SPECULO_THROW_WARNING(SpeculoResult::SPECULO_WARNING_BEST_PRACTICES, "Falling back to the default stream buffer for " + m_FilePath);
+                m_OutputBuffer.reset();
+            }
+        };
+
+        // MSVC only takes the buffer once the file is open, while libstdc++ silently ignores it from then on.
+#if !defined(_MSC_VER)
+        installOutputBuffer();
+#endif
+
+        m_OutputStream.open(m_FilePath, std::ios::binary | std::ios::out | std::ios::trunc);
+
+        if (m_OutputStream.fail())
+        {
+            SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_SERIALIZATION_FAILURE, m_FilePath);
+            return;
+        }
+
+#if defined(_MSC_VER)
+        installOutputBuffer(); // Still before the first write.
+#endif
+
         m_IsStreamOpen = true;
 
+        if (m_Flags & Serializer_Text_Flags_Compact)
+        {
+            m_ActiveEmitter.SetMapFormat(YAML::Flow);
+            m_ActiveEmitter.SetSeqFormat(YAML::Flow);
+        }
+
         m_ActiveEmitter << YAML::BeginMap;
 
         m_ActiveEmitter << YAML::Key << "Metadata";
@@ -61,23 +105,187 @@ namespace Speculo
         m_ActiveEmitter << YAML::Key << "Version_Revision" << YAML::Value << m_Version_Revision;
         m_ActiveEmitter << YAML::EndMap; // Metadata
 
-        m_ActiveEmitter << YAML::Newline << YAML::Newline;
+        if (!(m_Flags & Serializer_Text_Flags_Compact))
+        {
+            m_ActiveEmitter << YAML::Newline << YAML::Newline;
+        }
 
         m_ActiveEmitter << YAML::Key << "Data";
         m_ActiveEmitter << YAML::Value << YAML::BeginMap;
     }
 
+    void Serializer_Text::SerializeReflectedProperty(const std::string& propertyName, const void* object, const TypeDescriptor* type)
+    {
+        if (!m_IsStreamOpen)
+        {
+            SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_FILESTREAM_UNOPEN, m_FilePath);
+            return;
+        }
+
+        m_ActiveEmitter << YAML::Key << propertyName << YAML::Value;
+        m_DataPropertyCount++;
+
+        if (!Serializer_Text_Reflection::Emit(m_ActiveEmitter, object, type))
+        {
+            m_ActiveEmitter << YAML::Null; // Keeps the document well formed.
+            SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_SERIALIZATION_FAILURE, propertyName + " has neither a text codec nor reflected data members: " + m_FilePath);
+        }
+    }
+
+    void Serializer_Text::SerializeBinary(const std::string& propertyName, const void* data, size_t dataSize)
+    {
+        if (!m_IsStreamOpen)
+        {
+            SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_FILESTREAM_UNOPEN, m_FilePath);
+            return;
+        }
+
+        Serializer_Text_Base64::Encode(data, dataSize, m_EncodingBuffer);
+
+        m_ActiveEmitter << YAML::Key << propertyName << YAML::Value << YAML::SecondaryTag("binary") << YAML::DoubleQuoted << m_EncodingBuffer;
+        m_DataPropertyCount++;
+    }
+
+    SpeculoResult Serializer_Text::DeserializeBinary(const std::string& propertyName, void* buffer, size_t bufferSize, size_t* decodedSize)
+    {
+        *decodedSize = 0;
+
+        if (!m_IsStreamOpen)
+        {
+            SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_FILESTREAM_UNOPEN, m_FilePath);
+            return SpeculoResult::SPECULO_ERROR_FILESTREAM_UNOPEN;
+        }
+
+        const YAML::Node propertyNode = GetPropertyNode(propertyName);
+        if (!propertyNode.IsDefined())
+        {
+            return RecordDeserializationError(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_PROPERTY_NOT_FOUND, propertyName);
+        }
+
+        if (!propertyNode.IsScalar())
+        {
+            return RecordDeserializationError(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_CONVERSION_FAILURE, propertyName);
+        }
+
+        // Decoded from the node's own string. The blob is never copied on the way to the caller.
+        const std::string& encodedText = propertyNode.Scalar();
+        if (!Serializer_Text_Base64::Decode(encodedText, buffer, bufferSize, *decodedSize))
+        {
+            const size_t requiredSize = Serializer_Text_Base64::GetDecodedSize(encodedText);
+            if (requiredSize > bufferSize)
+            {
+                *decodedSize = requiredSize;
+                return SpeculoResult::SPECULO_ERROR_DESERIALIZATION_FAILURE;
+            }
+
+            *decodedSize = 0;
+            return RecordDeserializationError(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_CONVERSION_FAILURE, propertyName);
+        }
+
+        return SpeculoResult::SPECULO_SUCCESS;
+    }
+
+    void Serializer_Text_Section::SerializeReflectedProperty(const std::string& propertyName, const void* object, const TypeDescriptor* type)
+    {
+        m_Emitter << YAML::Key << propertyName << YAML::Value;
+
+        if (!Serializer_Text_Reflection::Emit(m_Emitter, object, type))
+        {
+            m_Emitter << YAML::Null;
+            SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_SERIALIZATION_FAILURE, m_Name + "." + propertyName + " has neither a text codec nor reflected data members");
+        }
+    }
+
+    void Serializer_Text::SerializeSection(const std::string& sectionName, std::function<void(Serializer_Text_Section&)> sectionBuilder)
+    {
+        if (!m_IsStreamOpen)
+        {
+            SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_FILESTREAM_UNOPEN, m_FilePath);
+            return;
+        }
+
+        if (!m_SectionPool)
+        {
+            m_SectionPool = std::make_unique<ThreadPool>(m_SectionThreadCount);
+        }
+
+        Serializer_Text_Section* section = m_Sections.emplace_back(std::make_unique<Serializer_Text_Section>()).get();
+        section->m_Name = sectionName;
+        section->m_Builder = std::move(sectionBuilder);
+
+        if (m_Flags & Serializer_Text_Flags_Compact)
+        {
+            section->m_Emitter.SetMapFormat(YAML::Flow);
+            section->m_Emitter.SetSeqFormat(YAML::Flow);
+        }
+
+        m_SectionPool->Submit([section](uint32_t)
+        {
+            section->m_Emitter << YAML::BeginMap;
+            section->m_Builder(*section);
+            section->m_Emitter << YAML::EndMap;
+
+            section->m_Builder = nullptr; // Release whatever the builder captured as soon as possible.
+        });
+    }
+
+    SpeculoResult Serializer_Text::DeserializeReflectedProperty(const std::string& propertyName, void* object, const TypeDescriptor* type)
+    {
+        if (!m_IsStreamOpen)
+        {
+            SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_FILESTREAM_UNOPEN, m_FilePath);
+            return SpeculoResult::SPECULO_ERROR_FILESTREAM_UNOPEN;
+        }
+
+        const YAML::Node propertyNode = GetPropertyNode(propertyName);
+        if (!propertyNode.IsDefined())
+        {
+            return RecordDeserializationError(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_PROPERTY_NOT_FOUND, propertyName);
+        }
+
+        std::vector<std::string> failedMembers;
+        if (Serializer_Text_Reflection::Decode(propertyNode, object, type, failedMembers))
+        {
+            return SpeculoResult::SPECULO_SUCCESS;
+        }
+
+        for (const std::string& failedMember : failedMembers)
+        {
+            RecordDeserializationError(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_CONVERSION_FAILURE, failedMember.empty() ? propertyName : propertyName + "." + failedMember);
+        }
+
+        return SpeculoResult::SPECULO_ERROR_DESERIALIZATION_CONVERSION_FAILURE;
+    }
+
     void Serializer_Text::EndSerialization()
     {
         if (m_IsStreamOpen)
         {
-            m_ActiveEmitter << YAML::EndMap; // Metadata Map
-            m_ActiveEmitter << YAML::EndMap; // Data Map
+            if (m_Sections.empty())
+            {
+                m_ActiveEmitter << YAML::EndMap; // Metadata Map
+                m_ActiveEmitter << YAML::EndMap; // Data Map
+            }
+            else
+            {
+                WriteSections(); // Closes the document itself.
+            }
 
-            // Output file.
-            std::ofstream outputFile(m_FilePath);
-            outputFile << m_ActiveEmitter.c_str();
-            
+            if (!m_ActiveEmitter.good())
+            {
+                SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_SERIALIZATION_FAILURE, m_ActiveEmitter.GetLastError() + ": " + m_FilePath);
+            }
+
+            // Everything but the tail end of the document is already on disk.
+            m_OutputStream.close();
+            if (m_OutputStream.fail())
+            {
+                SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_SERIALIZATION_FAILURE, m_FilePath);
+            }
+
+            m_OutputBuffer.reset();
+            m_IdentityAnchors.clear();
+            m_ContentAnchors.clear();
             m_IsStreamOpen = false;
         }
         else
@@ -87,10 +295,116 @@ namespace Speculo
         }
     }
 
+    std::string Serializer_Text::CreateAnchorName()
+    {
+        return "Shared_" + std::to_string(m_AnchorCount++);
+    }
+
+    std::shared_ptr<void> Serializer_Text::FindSharedInstance(const YAML::Node& node, const std::type_info& type) const
+    {
+        auto [instanceIterator, instanceEnd] = m_SharedInstances.equal_range(node.Mark().pos);
+        for (; instanceIterator != instanceEnd; instanceIterator++)
+        {
+            if (instanceIterator->second.m_Node.is(node) && *instanceIterator->second.m_Type == type)
+            {
+                return instanceIterator->second.m_Instance;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void Serializer_Text::AddSharedInstance(const YAML::Node& node, std::shared_ptr<void> instance, const std::type_info& type)
+    {
+        if (node.Mark().is_null()) // Nodes not parsed from text cannot have been aliased.
+        {
+            return;
+        }
+
+        Shared_Instance& sharedInstance = m_SharedInstances.emplace(node.Mark().pos, Shared_Instance())->second;
+        sharedInstance.m_Node = node;
+        sharedInstance.m_Instance = std::move(instance);
+        sharedInstance.m_Type = &type;
+    }
+
+    void Serializer_Text::WriteSections()
+    {
+        m_SectionPool->Wait();
+        m_SectionPool.reset();
+
+        // The emitter has written everything up to the last direct property of the Data map, and will not write the map's end
+        // until told to. Sections are appended after it as raw text, re-indented to sit one level within the Data map.
+        // Each section is a block map emitted at the root of its own emitter, which makes this a matter of prefixing every line.
+        const std::string sectionIndent(4, ' ');
+        const bool isCompact = m_Flags & Serializer_Text_Flags_Compact;
+        size_t writtenCount = m_DataPropertyCount;
+
+        if (isCompact && writtenCount == 0) // Flow maps only get their opening brace written along with their first entry.
+        {
+            m_OutputStream << "{";
+        }
+
+        for (const std::unique_ptr<Serializer_Text_Section>& section : m_Sections)
+        {
+            if (!section->m_Emitter.good())
+            {
+                SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_SERIALIZATION_FAILURE, section->m_Emitter.GetLastError() + ": " + section->m_Name + ": " + m_FilePath);
+                continue;
+            }
+
+            YAML::Emitter keyEmitter; // Quotes and escapes the name exactly like any other key.
+            keyEmitter << section->m_Name;
+
+            if (isCompact) // Flow style sections are always a single line.
+            {
+                m_OutputStream << (writtenCount++ == 0 ? "" : ", ") << keyEmitter.c_str() << ": " << section->m_Emitter.c_str();
+                continue;
+            }
+
+            m_OutputStream << (writtenCount++ == 0 ? "" : "\n") << "  " << keyEmitter.c_str() << ":";
+
+            const std::string_view sectionText(section->m_Emitter.c_str(), section->m_Emitter.size());
+            if (sectionText == "{}") // Empty maps stay on the key's line.
+            {
+                m_OutputStream << " " << sectionText;
+                continue;
+            }
+
+            size_t lineBegin = 0;
+            while (lineBegin < sectionText.size())
+            {
+                const size_t lineEnd = std::min(sectionText.find('\n', lineBegin), sectionText.size());
+                m_OutputStream << "\n";
+
+                if (lineEnd != lineBegin) // Blank lines stay blank, which keeps literal block scalars intact.
+                {
+                    m_OutputStream << sectionIndent;
+                    m_OutputStream.write(sectionText.data() + lineBegin, lineEnd - lineBegin);
+                }
+
+                lineBegin = lineEnd + 1;
+            }
+        }
+
+        if (isCompact)
+        {
+            m_OutputStream << "}}"; // Data, then the document.
+        }
+
+        m_Sections.clear();
+    }
+
     void Serializer_Text::EndDeserialization()
     {
         if (m_IsStreamOpen)
         {
+            ReportDeserializationErrors();
+
+            m_SharedInstances.clear();
+            m_LazySections.clear();
+            m_LazyDocument.clear();
+            m_LazyDocument.shrink_to_fit();
+
             m_IsStreamOpen = false;
         }
         else
@@ -102,6 +416,18 @@ namespace Speculo
 
     void Serializer_Text::BeginDeserialization()
     {
+        if (m_Flags & Serializer_Text_Flags_Lazy)
+        {
+            if (!FileSystem::ReadFileContents(m_FilePath, m_LazyDocument))
+            {
+                SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_FAILURE, m_FilePath);
+                return;
+            }
+
+            BeginLazyDeserialization();
+            return;
+        }
+
         // Explicit error handling as YAML functions don't throw useful asserts internally on errors.
         try
         {
@@ -112,6 +438,154 @@ namespace Speculo
             SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_FAILURE, thrownError.what());
         }
 
+        OpenDocument();
+    }
+
+    void Serializer_Text::BeginDeserialization(const std::string& fileContents)
+    {
+        if (m_Flags & Serializer_Text_Flags_Lazy)
+        {
+            m_LazyDocument = fileContents;
+
+            BeginLazyDeserialization();
+            return;
+        }
+
+        try
+        {
+            m_ActiveNode = YAML::Load(fileContents);
+        }
+        catch (std::exception& thrownError)
+        {
+            SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_FAILURE, thrownError.what() + std::string(": ") + m_FilePath);
+        }
+
+        OpenDocument();
+    }
+
+    void Serializer_Text::BeginLazyDeserialization()
+    {
+        Text_Document_Index documentIndex;
+
+        if (!Serializer_Text_Scanner::ScanDocument(m_LazyDocument, documentIndex))
+        {
+            // Not a layout the structural scan understands (i.e. flow style). Parse everything the regular way instead.
+            m_Flags &= ~Serializer_Text_Flags_Lazy;
+
+            BeginDeserialization(m_LazyDocument);
+
+            m_LazyDocument.clear();
+            m_LazyDocument.shrink_to_fit();
+            return;
+        }
+
+        // Only the Metadata block is parsed up front, which is what validation needs.
+        try
+        {
+            const Text_Section& metadataSection = documentIndex.m_Metadata;
+            m_ActiveNode = YAML::Load(m_LazyDocument.substr(metadataSection.m_Begin, metadataSection.m_End - metadataSection.m_Begin));
+        }
+        catch (std::exception& thrownError)
+        {
+            SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_FAILURE, thrownError.what() + std::string(": ") + m_FilePath);
+        }
+
+        m_IsStreamOpen = true;
+
+        ValidateMetadata();
+        m_ActiveNode = YAML::Node(YAML::NodeType::Map); // Stays empty. Lookups of keys the scan did not find resolve against it.
+
+        m_LazySections.reserve(documentIndex.m_DataSections.size());
+        for (const Text_Section& dataSection : documentIndex.m_DataSections)
+        {
+            Lazy_Section& lazySection = m_LazySections[dataSection.m_Key];
+            lazySection.m_Begin = dataSection.m_Begin;
+            lazySection.m_End = dataSection.m_End;
+        }
+    }
+
+    YAML::Node Serializer_Text::GetPropertyNode(const std::string& propertyName)
+    {
+        if (!(m_Flags & Serializer_Text_Flags_Lazy))
+        {
+            return m_ActiveNode[propertyName];
+        }
+
+        auto sectionIterator = m_LazySections.find(propertyName);
+        if (sectionIterator == m_LazySections.end())
+        {
+            return m_ActiveNode[propertyName];
+        }
+
+        Lazy_Section& lazySection = sectionIterator->second;
+        if (!lazySection.m_IsParsed)
+        {
+            lazySection.m_IsParsed = true;
+
+            try
+            {
+                // Each section is a single key map, still indented as it was inside Data.
+                YAML::Node sectionDocument = YAML::Load(m_LazyDocument.substr(lazySection.m_Begin, lazySection.m_End - lazySection.m_Begin));
+                lazySection.m_Node = sectionDocument.begin()->second;
+            }
+            catch (std::exception& thrownError)
+            {
+                SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_FAILURE, thrownError.what() + std::string(": ") + m_FilePath);
+                return m_ActiveNode[propertyName];
+            }
+        }
+
+        return lazySection.m_Node;
+    }
+
+    SpeculoResult Serializer_Text::RecordDeserializationError(SpeculoResult result, const std::string& propertyName)
+    {
+        Serializer_Text_Error& deserializationError = m_DeserializationErrors.emplace_back();
+        deserializationError.m_Result = result;
+        deserializationError.m_PropertyName = propertyName;
+
+        return result;
+    }
+
+    void Serializer_Text::ReportDeserializationErrors()
+    {
+        // One line per kind of failure rather than per property, as migrating old data can easily fail thousands of conversions.
+        constexpr size_t reportedNameLimit = 16;
+
+        for (SpeculoResult result : { SpeculoResult::SPECULO_ERROR_DESERIALIZATION_PROPERTY_NOT_FOUND, SpeculoResult::SPECULO_ERROR_DESERIALIZATION_CONVERSION_FAILURE })
+        {
+            size_t failureCount = 0;
+            std::string propertyNames;
+
+            for (const Serializer_Text_Error& deserializationError : m_DeserializationErrors)
+            {
+                if (deserializationError.m_Result != result)
+                {
+                    continue;
+                }
+
+                if (failureCount++ < reportedNameLimit)
+                {
+                    propertyNames += (failureCount == 1 ? "" : ", ") + deserializationError.m_PropertyName;
+                }
+            }
+
+            if (failureCount > reportedNameLimit)
+            {
+                propertyNames += " and " + std::to_string(failureCount - reportedNameLimit) + " more";
+            }
+
+            if (failureCount != 0)
+            {
+                SPECULO_THROW_ERROR(result, std::to_string(failureCount) + " properties in " + m_FilePath + " (" + propertyNames + ")");
+            }
+        }
+
+        m_DeserializationErrors.clear();
+    }
+
+    void Serializer_Text::OpenDocument()
+    {
         m_IsStreamOpen = true;
 
         ValidateMetadata();
@@ -120,37 +594,214 @@ namespace Speculo
 
     bool Serializer_Text::ValidateMetadata()
     {
-        YAML::Node metaData = m_ActiveNode["Metadata"];
+        Serializer_Metadata metadata;
 
-        if (!metaData.IsNull())
+        if (!DecodeMetadata(m_ActiveNode["Metadata"], metadata))
         {
-            if (metaData["Type"].as<std::string>() != m_FileType)
+            SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_FAILURE, m_FilePath);
+            return false;
+        }
+
+        return CheckMetadata(metadata);
+    }
+
+    bool Serializer_Text::DecodeMetadata(const YAML::Node& metadataNode, Serializer_Metadata& metadata)
+    {
+        if (!metadataNode.IsMap())
+        {
+            return false;
+        }
+
+        return TryDecode(metadataNode["Type"], metadata.m_FileType) &&
+               TryDecode(metadataNode["Version_Major"], metadata.m_Version_Major) &&
+               TryDecode(metadataNode["Version_Minor"], metadata.m_Version_Minor) &&
+               TryDecode(metadataNode["Version_Revision"], metadata.m_Version_Revision);
+    }
+
+    bool Serializer_Text::PeekMetadata(const std::string& filePath, Serializer_Metadata& metadata)
+    {
+        std::ifstream inputStream(FileSystem::ValidateAndAppendFileExtension(filePath, ".yml"), std::ios::binary);
+        if (inputStream.fail())
+        {
+            return false;
+        }
+
+        // Metadata is written first and usually fits well within the first read. Anything larger is read in growing chunks up to a limit,
+        // past which the file is unlikely to be ours.
+        std::string documentPrefix;
+        size_t readSize = m_PeekReadSize;
+
+        while (documentPrefix.size() < m_MaximumPeekSize)
+        {
+            const size_t previousSize = documentPrefix.size();
+            documentPrefix.resize(previousSize + readSize);
+            inputStream.read(documentPrefix.data() + previousSize, static_cast<std::streamsize>(readSize));
+            documentPrefix.resize(previousSize + static_cast<size_t>(inputStream.gcount()));
+
+            std::string_view metadataSlice;
+            const Text_Scan_Result scanResult = Serializer_Text_Scanner::FindMetadata(documentPrefix, inputStream.eof(), metadataSlice);
+
+            if (scanResult == Text_Scan_Result::NotFound)
             {
-                SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_TYPE_MISMATCH, m_FilePath);
                 return false;
             }
 
-            if (metaData["Version_Major"].as<int>() != m_Version_Major)
+            if (scanResult == Text_Scan_Result::Found)
             {
-                SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_VERSION_MAJOR_MISMATCH, m_FilePath);
-                return false;
+                try
+                {
+                    return DecodeMetadata(YAML::Load(std::string(metadataSlice)), metadata);
+                }
+                catch (std::exception&)
+                {
+                    return false;
+                }
             }
 
-            if (metaData["Version_Minor"].as<int>() != m_Version_Minor)
+            readSize = documentPrefix.size(); // Double up.
+        }
+
+        return false;
+    }
+
+    SpeculoResult Serializer_Text::PatchEncodedProperty(const std::string& filePath, const std::string& propertyName, std::string_view patchedEntry)
+    {
+        // Only the document up to the end of the patched entry is read, in growing chunks, so that patching near the start of a large file stays cheap.
+        std::string document;
+        Text_Section patchedSection;
+        Text_Scan_Result scanResult = Text_Scan_Result::Incomplete;
+        {
+            std::ifstream inputStream(filePath, std::ios::binary);
+            if (inputStream.fail())
             {
-                SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_VERSION_MINOR_MISMATCH, m_FilePath);
-                return false;
+                SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_FILESYSTEM_FILE_NOT_FOUND, filePath);
+                return SpeculoResult::SPECULO_ERROR_FILESYSTEM_FILE_NOT_FOUND;
+            }
+
+            size_t readSize = m_PatchReadSize;
+            while (scanResult == Text_Scan_Result::Incomplete)
+            {
+                const size_t previousSize = document.size();
+                document.resize(previousSize + readSize);
+                inputStream.read(document.data() + previousSize, static_cast<std::streamsize>(readSize));
+                document.resize(previousSize + static_cast<size_t>(inputStream.gcount()));
+
+                if (inputStream.bad())
+                {
+                    SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_FAILURE, filePath);
+                    return SpeculoResult::SPECULO_ERROR_DESERIALIZATION_FAILURE;
+                }
+
+                scanResult = Serializer_Text_Scanner::FindDataSection(document, inputStream.eof(), propertyName, patchedSection);
+                readSize = document.size(); // Double up.
             }
+        }
 
-            if (metaData["Version_Revision"].as<int>() != m_Version_Revision)
+        if (scanResult == Text_Scan_Result::Unsupported)
+        {
+            if (!FileSystem::ReadFileContents(filePath, document))
             {
-                SPECULO_THROW_WARNING(SpeculoResult::SPECULO_WARNING_VERSION_REVISION_MISMATCH, m_FilePath);
+                SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_FILESYSTEM_FILE_NOT_FOUND, filePath);
+                return SpeculoResult::SPECULO_ERROR_FILESYSTEM_FILE_NOT_FOUND;
             }
 
-            return true;
+            return PatchLoadedDocument(filePath, document, propertyName, patchedEntry);
         }
 
-        SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_FAILURE, m_FilePath);
-        return false;
+        if (scanResult == Text_Scan_Result::NotFound)
+        {
+            SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_PROPERTY_NOT_FOUND, propertyName + ": " + filePath);
+            return SpeculoResult::SPECULO_ERROR_DESERIALIZATION_PROPERTY_NOT_FOUND;
+        }
+
+        // The patch was emitted as a map of its own at the root. Indenting each of its lines to the level of the old entry slots it into the Data map.
+        const size_t entryBegin = patchedSection.m_Begin;
+        const std::string_view entryIndent = std::string_view(document).substr(entryBegin, document.find_first_not_of(' ', entryBegin) - entryBegin);
+
+        std::string entryText;
+        entryText.reserve(patchedEntry.size() + entryIndent.size() * 4);
+
+        for (size_t lineBegin = 0; lineBegin < patchedEntry.size();)
+        {
+            const size_t lineEnd = std::min(patchedEntry.find('\n', lineBegin), patchedEntry.size());
+            if (lineEnd != lineBegin)
+            {
+                entryText.append(entryIndent).append(patchedEntry.substr(lineBegin, lineEnd - lineBegin));
+            }
+
+            if (lineEnd != patchedEntry.size())
+            {
+                entryText.push_back('\n');
+            }
+
+            lineBegin = lineEnd + 1;
+        }
+
+        // Blank lines and comments trailing the old entry are left where they are. Padding left on its last line by an earlier patch is reused.
+        const size_t lastCharacter = document.find_last_not_of(" \t\r\n", patchedSection.m_End - 1);
+        const size_t entryEnd = std::min(document.find_first_of("\r\n", lastCharacter), patchedSection.m_End);
+        const size_t entrySize = entryEnd - entryBegin;
+
+        if (entryText.size() <= entrySize) // Trailing spaces are insignificant, and let us avoid moving anything that follows.
+        {
+            entryText.resize(entrySize, ' ');
+        }
+
+        if (!FileSystem::SpliceFileContents(filePath, entryBegin, entrySize, entryText.data(), entryText.size()))
+        {
+            SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_SERIALIZATION_FAILURE, filePath);
+            return SpeculoResult::SPECULO_ERROR_SERIALIZATION_FAILURE;
+        }
+
+        return SpeculoResult::SPECULO_SUCCESS;
+    }
+
+    SpeculoResult Serializer_Text::PatchLoadedDocument(const std::string& filePath, const std::string& document, const std::string& propertyName, std::string_view patchedEntry)
+    {
+        YAML::Emitter documentEmitter;
+
+        try
+        {
+            YAML::Node documentNode = YAML::Load(document);
+            YAML::Node dataNode = documentNode["Data"];
+
+            if (!dataNode.IsMap() || !dataNode[propertyName])
+            {
+                SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_PROPERTY_NOT_FOUND, propertyName + ": " + filePath);
+                return SpeculoResult::SPECULO_ERROR_DESERIALIZATION_PROPERTY_NOT_FOUND;
+            }
+
+            dataNode[propertyName] = YAML::Load(std::string(patchedEntry))[propertyName];
+            documentEmitter << documentNode; // Nodes remember whether they were read in flow style, so compact documents stay compact.
+        }
+        catch (std::exception& thrownError)
+        {
+            SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_FAILURE, thrownError.what() + std::string(": ") + filePath);
+            return SpeculoResult::SPECULO_ERROR_DESERIALIZATION_FAILURE;
+        }
+
+        // Written next to the original first, so that a failed write never leaves a half written document behind.
+        const std::string temporaryPath = filePath + ".patch";
+        {
+            std::ofstream outputFile(temporaryPath, std::ios::binary | std::ios::trunc);
+            outputFile.write(documentEmitter.c_str(), static_cast<std::streamsize>(documentEmitter.size()));
+
+            if (outputFile.fail())
+            {
+                SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_SERIALIZATION_FAILURE, temporaryPath);
+                return SpeculoResult::SPECULO_ERROR_SERIALIZATION_FAILURE;
+            }
+        }
+
+        std::error_code errorCode;
+        std::filesystem::rename(temporaryPath, filePath, errorCode);
+
+        if (errorCode)
+        {
+            SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_SERIALIZATION_FAILURE, errorCode.message() + ": " + filePath);
+            return SpeculoResult::SPECULO_ERROR_SERIALIZATION_FAILURE;
+        }
+
+        return SpeculoResult::SPECULO_SUCCESS;
     }
 }
\ No newline at end of file
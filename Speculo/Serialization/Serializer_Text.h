@@ -1,17 +1,70 @@
 #pragma once
+#include <fstream>
+#include <functional>
+#include <memory>
 #include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
 #include "Serializer_Core.h"
 #include "Serializer_Text_Utilities.h"
+#include "Serializer_Text_Reflection.h"
 
 namespace Speculo
 {
+    enum Serializer_Text_Flags : uint32_t
+    {
+        Serializer_Text_Flags_None = 0,
+        Serializer_Text_Flags_Lazy = 1 << 0,   // Deserialization: Only index the top-level keys of the Data map on open. Each one is parsed on first access.
+        Serializer_Text_Flags_Compact = 1 << 1 // Serialization: Write the whole document in flow style on a single line, for files never meant to be read by people.
+    };
+
+    struct Serializer_Text_Error
+    {
+        SpeculoResult m_Result = SpeculoResult::SPECULO_SUCCESS;
+        std::string m_PropertyName;
+    };
+
+    class ThreadPool;
+
+    // A top-level property of the Data map built in its own emitter, away from the serializer that owns it. See Serializer_Text::SerializeSection.
+    class Serializer_Text_Section
+    {
+    public:
+        template <typename T>
+        void SerializeProperty(const std::string& propertyName, T value)
+        {
+            m_Emitter << YAML::Key << propertyName << YAML::Value << value;
+        }
+
+        template <typename T>
+        void SerializeReflectedProperty(const std::string& propertyName, const T& value)
+        {
+            SerializeReflectedProperty(propertyName, &value, Details::Resolve<T>());
+        }
+
+        void SerializeReflectedProperty(const std::string& propertyName, const void* object, const TypeDescriptor* type);
+
+        const std::string& GetName() const { return m_Name; }
+
+    private:
+        friend class Serializer_Text;
+
+        std::string m_Name;
+        std::function<void(Serializer_Text_Section&)> m_Builder;
+        YAML::Emitter m_Emitter;
+    };
+
     // This is a data container for serialization/deserialization purposes. It can only be used for either one at any point in time, and not both together at the same time.
     class Serializer_Text : public Serializer_Core
     {
     public:
         Serializer_Text() = delete;
         ~Serializer_Text();
-        explicit Serializer_Text(Serializer_Operation_Type operationType, const std::string& filePath, const std::string& fileType) noexcept;
+        explicit Serializer_Text(Serializer_Operation_Type operationType, const std::string& filePath, const std::string& fileType, uint32_t flags = Serializer_Text_Flags_None) noexcept;
+
+        // Deserializes from a document already read into memory. The file path is only kept around for error reporting.
+        explicit Serializer_Text(const std::string& filePath, const std::string& fileType, const std::string& fileContents, uint32_t flags = Serializer_Text_Flags_None) noexcept;
 
         // Serialize
         template <typename T>
@@ -20,6 +73,7 @@ namespace Speculo
             if (m_IsStreamOpen)
             {
                 m_ActiveEmitter << YAML::Key << propertyName << YAML::Value << value;
+                m_DataPropertyCount++;
             }
             else
             {
@@ -28,49 +82,305 @@ namespace Speculo
             }
         }
 
+        // Serializes any type registered through Speculo::Reflect<T>() by walking its data members, without a hand-written YAML::convert<T>.
+        template <typename T>
+        void SerializeReflectedProperty(const std::string& propertyName, const T& value)
+        {
+            SerializeReflectedProperty(propertyName, &value, Details::Resolve<T>());
+        }
+
+        void SerializeReflectedProperty(const std::string& propertyName, const void* object, const TypeDescriptor* type);
+
+        // Objects referenced from several places are written out in full once, under an anchor, and as an alias to it everywhere after.
+        // Use DeserializeSharedProperty to get the sharing back. Null pointers are written as null.
+        template <typename T>
+        void SerializeSharedProperty(const std::string& propertyName, const std::shared_ptr<T>& value)
+        {
+            if (!m_IsStreamOpen)
+            {
+                SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_FILESTREAM_UNOPEN, m_FilePath);
+                return;
+            }
+
+            m_ActiveEmitter << YAML::Key << propertyName << YAML::Value;
+            m_DataPropertyCount++;
+
+            if (!value)
+            {
+                m_ActiveEmitter << YAML::Null;
+                return;
+            }
+
+            auto [anchorIterator, isFirstReference] = m_IdentityAnchors.try_emplace(value.get());
+            if (!isFirstReference)
+            {
+                m_ActiveEmitter << YAML::Alias(anchorIterator->second.m_Anchor);
+                return;
+            }
+
+            anchorIterator->second.m_Instance = value; // Keeps the address from being reused by another object while we still map it.
+            anchorIterator->second.m_Anchor = CreateAnchorName();
+            m_ActiveEmitter << YAML::Anchor(anchorIterator->second.m_Anchor) << *value;
+        }
+
+        // Same as above, but for values that are equal rather than the same object. Each value is first emitted on its own and compared
+        // against everything anchored before it, which costs one extra emission per property in exchange for never writing a value twice.
+        template <typename T>
+        void SerializeDeduplicatedProperty(const std::string& propertyName, const T& value)
+        {
+            if (!m_IsStreamOpen)
+            {
+                SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_FILESTREAM_UNOPEN, m_FilePath);
+                return;
+            }
+
+            YAML::Emitter contentEmitter;
+            if (m_Flags & Serializer_Text_Flags_Compact)
+            {
+                contentEmitter.SetMapFormat(YAML::Flow);
+                contentEmitter.SetSeqFormat(YAML::Flow);
+            }
+
+            contentEmitter << value;
+
+            m_ActiveEmitter << YAML::Key << propertyName << YAML::Value;
+            m_DataPropertyCount++;
+
+            auto [anchorIterator, isFirstOccurrence] = m_ContentAnchors.try_emplace(std::string(contentEmitter.c_str(), contentEmitter.size()));
+            if (!isFirstOccurrence)
+            {
+                m_ActiveEmitter << YAML::Alias(anchorIterator->second);
+                return;
+            }
+
+            anchorIterator->second = CreateAnchorName();
+            m_ActiveEmitter << YAML::Anchor(anchorIterator->second) << value;
+        }
+
+        // Embeds a blob as base64, tagged !!binary the same way YAML::Binary is, so either can read what the other wrote.
+        void SerializeBinary(const std::string& propertyName, const void* data, size_t dataSize);
+
+        // Queues up a top-level map property whose contents are built by sectionBuilder on a worker thread, in an emitter of its own.
+        // Sections are written after every directly serialized property at EndSerialization, in the order they were added.
+        // sectionBuilder runs concurrently with the calling thread and other sections, so it must not touch shared state without synchronizing.
+        void SerializeSection(const std::string& sectionName, std::function<void(Serializer_Text_Section&)> sectionBuilder);
+
+        // Number of workers building sections. Only takes effect before the first call to SerializeSection. 0 uses every hardware thread available.
+        void SetSectionThreadCount(uint32_t threadCount) { m_SectionThreadCount = threadCount; }
+
         // Deserialize
+        // Failures are recorded rather than thrown or printed one by one, and reported together at EndDeserialization.
+        // The value is left untouched unless SPECULO_SUCCESS is returned.
         template <typename T>
-        void DeserializeProperty(const std::string& propertyName, T* value)
+        SpeculoResult DeserializeProperty(const std::string& propertyName, T* value)
         {
             if (m_IsStreamOpen)
             {
-                try
+                const YAML::Node propertyNode = GetPropertyNode(propertyName);
+                if (!propertyNode.IsDefined())
                 {
-                    *value = m_ActiveNode[propertyName].as<T>();
+                    return RecordDeserializationError(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_PROPERTY_NOT_FOUND, propertyName);
                 }
-                catch (std::exception& thrownError)
+
+                T decodedValue;
+                if (!TryDecode(propertyNode, decodedValue))
                 {
-                    SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_FAILURE, thrownError.what() + std::string(": ") + m_FilePath);
+                    return RecordDeserializationError(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_CONVERSION_FAILURE, propertyName);
                 }
+
+                *value = std::move(decodedValue);
+                return SpeculoResult::SPECULO_SUCCESS;
             }
             else
             {
                 SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_FILESTREAM_UNOPEN, m_FilePath);
-                return;
+                return SpeculoResult::SPECULO_ERROR_FILESTREAM_UNOPEN;
             }
         }
 
+        // Same as above, but falls back to defaultValue whenever the property is missing or fails to convert.
+        template <typename T>
+        SpeculoResult DeserializeProperty(const std::string& propertyName, T* value, const T& defaultValue)
+        {
+            const SpeculoResult result = DeserializeProperty(propertyName, value);
+            if (result != SpeculoResult::SPECULO_SUCCESS)
+            {
+                *value = defaultValue;
+            }
+
+            return result;
+        }
+
         template <typename T>
         T DeserializePropertyAs(const std::string& propertyName)
         {
-            T value;
+            T value{}; // Left as is when the property is missing or fails to convert.
             DeserializeProperty(propertyName, &value);
             return value;
         }
 
+        template <typename T>
+        T DeserializePropertyAs(const std::string& propertyName, const T& defaultValue)
+        {
+            T value{};
+            DeserializeProperty(propertyName, &value, defaultValue);
+            return value;
+        }
+
+        // Properties written as aliases of the same anchor resolve to the same instance, as long as they are read back as the same type.
+        template <typename T>
+        SpeculoResult DeserializeSharedProperty(const std::string& propertyName, std::shared_ptr<T>* value)
+        {
+            if (!m_IsStreamOpen)
+            {
+                SPECULO_THROW_ERROR(SpeculoResult::SPECULO_ERROR_FILESTREAM_UNOPEN, m_FilePath);
+                return SpeculoResult::SPECULO_ERROR_FILESTREAM_UNOPEN;
+            }
+
+            const YAML::Node propertyNode = GetPropertyNode(propertyName);
+            if (!propertyNode.IsDefined())
+            {
+                return RecordDeserializationError(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_PROPERTY_NOT_FOUND, propertyName);
+            }
+
+            if (propertyNode.IsNull())
+            {
+                value->reset();
+                return SpeculoResult::SPECULO_SUCCESS;
+            }
+
+            if (std::shared_ptr<void> sharedInstance = FindSharedInstance(propertyNode, typeid(T)))
+            {
+                *value = std::static_pointer_cast<T>(sharedInstance);
+                return SpeculoResult::SPECULO_SUCCESS;
+            }
+
+            std::shared_ptr<T> decodedValue = std::make_shared<T>();
+            if (!TryDecode(propertyNode, *decodedValue))
+            {
+                return RecordDeserializationError(SpeculoResult::SPECULO_ERROR_DESERIALIZATION_CONVERSION_FAILURE, propertyName);
+            }
+
+            AddSharedInstance(propertyNode, decodedValue, typeid(T));
+            *value = std::move(decodedValue);
+            return SpeculoResult::SPECULO_SUCCESS;
+        }
+
+        // Decodes straight into buffer. decodedSize receives the number of bytes written, or the size needed if bufferSize is too small,
+        // in which case SPECULO_ERROR_DESERIALIZATION_FAILURE is returned and nothing is recorded, so that callers can grow their buffer and retry.
+        SpeculoResult DeserializeBinary(const std::string& propertyName, void* buffer, size_t bufferSize, size_t* decodedSize);
+
+        // Members that fail to convert are recorded individually (i.e. "Player.Transform.Position") and left untouched, while the rest are still read.
+        template <typename T>
+        SpeculoResult DeserializeReflectedProperty(const std::string& propertyName, T* value)
+        {
+            return DeserializeReflectedProperty(propertyName, value, Details::Resolve<T>());
+        }
+
+        SpeculoResult DeserializeReflectedProperty(const std::string& propertyName, void* object, const TypeDescriptor* type);
+
         virtual void EndSerialization() override;
         virtual void EndDeserialization() override;
 
+        bool IsStreamOpen() const { return m_IsStreamOpen; }
+
+        // Rewrites a single top-level property of an existing file without loading the rest of it. The new value is written over the old one in place
+        // when it fits (padded out with spaces), and spliced in otherwise. Documents the structural scan does not understand (flow style,
+        // anchors) are loaded, modified and written back whole instead.
+        template <typename T>
+        static SpeculoResult PatchProperty(const std::string& filePath, const std::string& propertyName, const T& value)
+        {
+            YAML::Emitter patchEmitter;
+            patchEmitter << YAML::BeginMap << YAML::Key << propertyName << YAML::Value << value << YAML::EndMap;
+
+            return PatchEncodedProperty(FileSystem::ValidateAndAppendFileExtension(filePath, ".yml"), propertyName, std::string_view(patchEmitter.c_str(), patchEmitter.size()));
+        }
+
+        // Reads and parses only the Metadata block at the start of the file, typically a few hundred bytes, without opening it for deserialization.
+        // Never reports errors itself, as it is meant to be run over large numbers of files which may not even be ours.
+        static bool PeekMetadata(const std::string& filePath, Serializer_Metadata& metadata);
+
+        // Every property that failed to deserialize so far. Cleared once reported at EndDeserialization.
+        const std::vector<Serializer_Text_Error>& GetDeserializationErrors() const { return m_DeserializationErrors; }
+
     private:
         virtual void BeginSerialization() override;
         virtual void BeginDeserialization() override;
         virtual bool ValidateMetadata() override;
 
+        void BeginDeserialization(const std::string& fileContents);
+        void BeginLazyDeserialization();
+        void OpenDocument();
+        void WriteSections();
+        static bool DecodeMetadata(const YAML::Node& metadataNode, Serializer_Metadata& metadata);
+        static SpeculoResult PatchEncodedProperty(const std::string& filePath, const std::string& propertyName, std::string_view patchedEntry);
+        static SpeculoResult PatchLoadedDocument(const std::string& filePath, const std::string& document, const std::string& propertyName, std::string_view patchedEntry);
+
+        YAML::Node GetPropertyNode(const std::string& propertyName);
+        SpeculoResult RecordDeserializationError(SpeculoResult result, const std::string& propertyName);
+
+        std::string CreateAnchorName();
+        std::shared_ptr<void> FindSharedInstance(const YAML::Node& node, const std::type_info& type) const;
+        void AddSharedInstance(const YAML::Node& node, std::shared_ptr<void> instance, const std::type_info& type);
+        void ReportDeserializationErrors();
+
     private:
+        struct Lazy_Section
+        {
+            size_t m_Begin = 0; // Byte range within m_LazyDocument.
+            size_t m_End = 0;
+            YAML::Node m_Node;
+            bool m_IsParsed = false;
+        };
+
+        static constexpr size_t m_PeekReadSize = 512;
+        static constexpr size_t m_MaximumPeekSize = 64 * 1024;
+        static constexpr size_t m_OutputBufferSize = 1024 * 1024;
+        static constexpr size_t m_PatchReadSize = 64 * 1024;
+
+        // The emitter writes straight through to the file as properties are added, so memory use stays at the size of the
+        // output buffer no matter how large the document gets. Declared ahead of the emitter, which holds on to the stream.
+        std::unique_ptr<char[]> m_OutputBuffer;
+        std::ofstream m_OutputStream;
+
         // YAML
-        YAML::Emitter m_ActiveEmitter; // Serialization
+        YAML::Emitter m_ActiveEmitter { m_OutputStream }; // Serialization
+        size_t m_DataPropertyCount = 0;
+
+        // Parallel Sections
+        std::unique_ptr<ThreadPool> m_SectionPool;
+        std::vector<std::unique_ptr<Serializer_Text_Section>> m_Sections;
+        uint32_t m_SectionThreadCount = 0;
         YAML::Node m_ActiveNode;       // Deserialization
 
+        std::vector<Serializer_Text_Error> m_DeserializationErrors;
+
+        std::string m_EncodingBuffer; // Reused by every binary property.
+
+        // Anchors & Aliases
+        struct Identity_Anchor
+        {
+            std::shared_ptr<const void> m_Instance;
+            std::string m_Anchor;
+        };
+
+        struct Shared_Instance
+        {
+            YAML::Node m_Node;
+            std::shared_ptr<void> m_Instance;
+            const std::type_info* m_Type = nullptr;
+        };
+
+        std::unordered_map<const void*, Identity_Anchor> m_IdentityAnchors;
+        std::unordered_map<std::string, std::string> m_ContentAnchors; // Emitted text -> Anchor. Keyed by the full text so that hash collisions never alias different values.
+        std::unordered_multimap<int, Shared_Instance> m_SharedInstances; // Keyed by the position of the node within the document, which aliases share with their anchor.
+        uint32_t m_AnchorCount = 0;
+
+        // Lazy Deserialization
+        std::string m_LazyDocument;
+        std::unordered_map<std::string, Lazy_Section> m_LazySections;
+
+        uint32_t m_Flags = Serializer_Text_Flags_None;
         bool m_IsStreamOpen = false;
     };
 }
\ No newline at end of file
@@ -0,0 +1,281 @@
+#include "SpeculoPCH.h"
+#include "Serializer_Text_Base64.h"
+#include <array>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define SPECULO_BASE64_SSSE3
+    #include <tmmintrin.h>
+
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define SPECULO_TARGET_SSSE3
+    #else
+        #define SPECULO_TARGET_SSSE3 __attribute__((target("ssse3"))) // Lets the intrinsics compile without building everything else for SSSE3.
+    #endif
+#endif
+
+namespace Speculo
+{
+    namespace
+    {
+        constexpr char g_EncodeTable[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        constexpr uint8_t g_InvalidCharacter = 0xFF;
+        constexpr uint8_t g_WhitespaceCharacter = 0xFE;
+        constexpr uint8_t g_PaddingCharacter = 0xFD;
+
+        constexpr std::array<uint8_t, 256> CreateDecodeTable()
+        {
+            std::array<uint8_t, 256> decodeTable = {};
+            for (uint8_t& decodedValue : decodeTable)
+            {
+                decodedValue = g_InvalidCharacter;
+            }
+
+            for (uint8_t index = 0; index < 64; index++)
+            {
+                decodeTable[static_cast<uint8_t>(g_EncodeTable[index])] = index;
+            }
+
+            decodeTable[' '] = decodeTable['\n'] = decodeTable['\r'] = decodeTable['\t'] = g_WhitespaceCharacter;
+            decodeTable['='] = g_PaddingCharacter;
+            return decodeTable;
+        }
+
+        constexpr std::array<uint8_t, 256> g_DecodeTable = CreateDecodeTable();
+
+#if defined(SPECULO_BASE64_SSSE3)
+        bool HasSSSE3()
+        {
+    #if defined(_MSC_VER)
+            int cpuInfo[4] = {};
+            __cpuid(cpuInfo, 1);
+            return (cpuInfo[2] & (1 << 9)) != 0;
+    #else
+            return __builtin_cpu_supports("ssse3");
+    #endif
+        }
+
+        // Splits 12 bytes into 16 6-bit indices and maps them onto the alphabet without a table lookup per byte.
+        // See Wojciech Muła, "Base64 encoding with SIMD instructions".
+        SPECULO_TARGET_SSSE3 size_t EncodeSSSE3(const uint8_t* data, size_t dataSize, char* encodedText)
+        {
+            const __m128i shuffleInput = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+            const __m128i shiftTable = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                                     '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+            size_t dataOffset = 0;
+            char* output = encodedText;
+
+            for (; dataOffset + 16 <= dataSize; dataOffset += 12, output += 16) // Loads 16 bytes to consume 12.
+            {
+                __m128i input = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + dataOffset)), shuffleInput);
+
+                const __m128i highBits = _mm_mulhi_epu16(_mm_and_si128(input, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+                const __m128i lowBits = _mm_mullo_epi16(_mm_and_si128(input, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+                const __m128i indices = _mm_or_si128(highBits, lowBits);
+
+                __m128i shiftIndices = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+                const __m128i isUppercase = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+                shiftIndices = _mm_or_si128(shiftIndices, _mm_and_si128(isUppercase, _mm_set1_epi8(13)));
+
+                const __m128i characters = _mm_add_epi8(_mm_shuffle_epi8(shiftTable, shiftIndices), indices);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(output), characters);
+            }
+
+            return dataOffset;
+        }
+
+        // Validates and translates 16 characters at once through nibble lookups, then packs their 6-bit values into 12 bytes.
+        // See Wojciech Muła and Daniel Lemire, "Faster Base64 Encoding and Decoding Using AVX2 Instructions".
+        SPECULO_TARGET_SSSE3 size_t DecodeSSSE3(const char* encodedText, size_t encodedSize, uint8_t* buffer, size_t bufferSize, size_t& decodedSize)
+        {
+            const __m128i lowNibbleTable = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+            const __m128i highNibbleTable = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+            const __m128i rollTable = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+            const __m128i packOutput = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+            size_t encodedOffset = 0;
+            alignas(16) uint8_t packedBytes[16];
+
+            for (; encodedOffset + 16 <= encodedSize && decodedSize + 12 <= bufferSize; encodedOffset += 16, decodedSize += 12)
+            {
+                const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(encodedText + encodedOffset));
+                const __m128i highNibbles = _mm_and_si128(_mm_srli_epi32(input, 4), _mm_set1_epi8(0x0F));
+                const __m128i lowNibbles = _mm_and_si128(input, _mm_set1_epi8(0x0F));
+
+                const __m128i invalidBits = _mm_and_si128(_mm_shuffle_epi8(lowNibbleTable, lowNibbles), _mm_shuffle_epi8(highNibbleTable, highNibbles));
+                if (_mm_movemask_epi8(_mm_cmpgt_epi8(invalidBits, _mm_setzero_si128())) != 0) // Padding, whitespace or garbage. Left to the scalar path.
+                {
+                    break;
+                }
+
+                const __m128i isSlash = _mm_cmpeq_epi8(input, _mm_set1_epi8('/'));
+                const __m128i values = _mm_add_epi8(input, _mm_shuffle_epi8(rollTable, _mm_add_epi8(isSlash, highNibbles)));
+
+                const __m128i mergedPairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+                const __m128i mergedQuads = _mm_madd_epi16(mergedPairs, _mm_set1_epi32(0x00011000));
+                _mm_store_si128(reinterpret_cast<__m128i*>(packedBytes), _mm_shuffle_epi8(mergedQuads, packOutput));
+
+                std::memcpy(buffer + decodedSize, packedBytes, 12);
+            }
+
+            return encodedOffset;
+        }
+#endif
+
+        const bool g_IsVectorized =
+#if defined(SPECULO_BASE64_SSSE3)
+            HasSSSE3();
+#else
+            false;
+#endif
+    }
+
+    bool Serializer_Text_Base64::IsVectorized()
+    {
+        return g_IsVectorized;
+    }
+
+    size_t Serializer_Text_Base64::GetDecodedSize(std::string_view encodedText)
+    {
+        size_t characterCount = 0;
+        for (char character : encodedText)
+        {
+            characterCount += g_DecodeTable[static_cast<uint8_t>(character)] < 64;
+        }
+
+        return characterCount * 6 / 8;
+    }
+
+    void Serializer_Text_Base64::Encode(const void* data, size_t dataSize, std::string& encodedText)
+    {
+        encodedText.resize(GetEncodedSize(dataSize));
+
+        const uint8_t* dataBytes = static_cast<const uint8_t*>(data);
+        size_t dataOffset = 0;
+
+#if defined(SPECULO_BASE64_SSSE3)
+        if (g_IsVectorized)
+        {
+            dataOffset = EncodeSSSE3(dataBytes, dataSize, encodedText.data());
+        }
+#endif
+
+        EncodeScalar(dataBytes + dataOffset, dataSize - dataOffset, encodedText.data() + dataOffset / 3 * 4);
+    }
+
+    bool Serializer_Text_Base64::Decode(std::string_view encodedText, void* buffer, size_t bufferSize, size_t& decodedSize)
+    {
+        uint8_t* bufferBytes = static_cast<uint8_t*>(buffer);
+        size_t encodedOffset = 0;
+        decodedSize = 0;
+
+#if defined(SPECULO_BASE64_SSSE3)
+        if (g_IsVectorized)
+        {
+            encodedOffset = DecodeSSSE3(encodedText.data(), encodedText.size(), bufferBytes, bufferSize, decodedSize);
+        }
+#endif
+
+        // Whole groups of 4 were consumed, so the scalar path picks up on a group boundary.
+        size_t tailSize = 0;
+        if (!DecodeScalar(encodedText.substr(encodedOffset), bufferBytes + decodedSize, bufferSize - decodedSize, tailSize))
+        {
+            return false;
+        }
+
+        decodedSize += tailSize;
+        return true;
+    }
+
+    size_t Serializer_Text_Base64::EncodeScalar(const uint8_t* data, size_t dataSize, char* encodedText)
+    {
+        char* output = encodedText;
+        size_t dataOffset = 0;
+
+        for (; dataOffset + 3 <= dataSize; dataOffset += 3)
+        {
+            const uint32_t group = (data[dataOffset] << 16) | (data[dataOffset + 1] << 8) | data[dataOffset + 2];
+            *output++ = g_EncodeTable[(group >> 18) & 0x3F];
+            *output++ = g_EncodeTable[(group >> 12) & 0x3F];
+            *output++ = g_EncodeTable[(group >> 6) & 0x3F];
+            *output++ = g_EncodeTable[group & 0x3F];
+        }
+
+        if (const size_t remainder = dataSize - dataOffset; remainder != 0)
+        {
+            const uint32_t group = (data[dataOffset] << 16) | (remainder == 2 ? data[dataOffset + 1] << 8 : 0);
+            *output++ = g_EncodeTable[(group >> 18) & 0x3F];
+            *output++ = g_EncodeTable[(group >> 12) & 0x3F];
+            *output++ = remainder == 2 ? g_EncodeTable[(group >> 6) & 0x3F] : '=';
+            *output++ = '=';
+        }
+
+        return output - encodedText;
+    }
+
+    bool Serializer_Text_Base64::DecodeScalar(std::string_view encodedText, uint8_t* buffer, size_t bufferSize, size_t& decodedSize)
+    {
+        uint32_t group = 0;
+        uint32_t groupSize = 0;
+        bool hasPadding = false;
+        decodedSize = 0;
+
+        for (char character : encodedText)
+        {
+            const uint8_t value = g_DecodeTable[static_cast<uint8_t>(character)];
+
+            if (value == g_WhitespaceCharacter)
+            {
+                continue;
+            }
+
+            if (value == g_PaddingCharacter)
+            {
+                hasPadding = true;
+                continue;
+            }
+
+            if (value == g_InvalidCharacter || hasPadding) // Nothing but padding and whitespace may follow padding.
+            {
+                return false;
+            }
+
+            group = (group << 6) | value;
+            if (++groupSize == 4)
+            {
+                if (decodedSize + 3 > bufferSize)
+                {
+                    return false;
+                }
+
+                buffer[decodedSize++] = static_cast<uint8_t>(group >> 16);
+                buffer[decodedSize++] = static_cast<uint8_t>(group >> 8);
+                buffer[decodedSize++] = static_cast<uint8_t>(group);
+                group = 0;
+                groupSize = 0;
+            }
+        }
+
+        if (groupSize == 1) // 6 bits do not make a byte.
+        {
+            return false;
+        }
+
+        // 2 or 3 leftover characters carry 1 or 2 bytes.
+        const size_t tailSize = groupSize == 0 ? 0 : groupSize - 1;
+        if (decodedSize + tailSize > bufferSize)
+        {
+            return false;
+        }
+
+        group <<= 6 * (4 - groupSize);
+        for (size_t tailIndex = 0; tailIndex < tailSize; tailIndex++)
+        {
+            buffer[decodedSize++] = static_cast<uint8_t>(group >> (16 - tailIndex * 8));
+        }
+
+        return true;
+    }
+}
\ No newline at end of file
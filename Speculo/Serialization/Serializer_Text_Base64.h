@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Speculo
+{
+    // Standard base64 (RFC 4648, with padding) for embedding binary blobs within text documents, as tagged by !!binary.
+    // Encoding and decoding run 12 bytes at a time with SSSE3 on CPUs that support it, and fall back to a scalar loop everywhere else
+    // as well as for the tail end of every buffer. Decoding tolerates whitespace and line breaks, which sends the remainder down the scalar path.
+    class Serializer_Text_Base64
+    {
+    public:
+        static size_t GetEncodedSize(size_t dataSize) { return (dataSize + 2) / 3 * 4; }
+
+        // Exact number of bytes Decode() writes for a valid encoding. Scans the whole text, as whitespace does not count.
+        static size_t GetDecodedSize(std::string_view encodedText);
+
+        // Overwrites encodedText, reusing its capacity.
+        static void Encode(const void* data, size_t dataSize, std::string& encodedText);
+
+        // Writes straight into buffer. Returns false on invalid characters or if buffer is too small, in which case its contents are unspecified.
+        static bool Decode(std::string_view encodedText, void* buffer, size_t bufferSize, size_t& decodedSize);
+
+        static bool IsVectorized();
+
+    private:
+        static size_t EncodeScalar(const uint8_t* data, size_t dataSize, char* encodedText);
+        static bool DecodeScalar(std::string_view encodedText, uint8_t* buffer, size_t bufferSize, size_t& decodedSize);
+    };
+}
\ No newline at end of file
@@ -0,0 +1,392 @@
+#include "SpeculoPCH.h"
+#include "Serializer_Text_Reflection.h"
+#include <array>
+#include <atomic>
+
+namespace Speculo
+{
+    namespace
+    {
+        // Published like the cached tables of a TypeDescriptor: Registering a codec copies the table rather than changing it in place.
+        struct Text_Codec_Table
+        {
+            std::unordered_map<const TypeDescriptor*, Text_Codec> m_Codecs;
+        };
+
+        struct Text_Plan_Entry
+        {
+            const TypeDescriptor* m_Type = nullptr;
+            std::unique_ptr<Text_Binding_Plan> m_Plan; // Null for types without reflected data members.
+            Text_Plan_Entry* m_Next = nullptr;          // Within the same bucket. Never changes once published.
+        };
+
+        // Entries are pushed onto per bucket lists under the registration mutex, so Emit and Decode find plans without taking any lock.
+        // Registering a codec or a member publishes a fresh, empty cache, as plans point at both.
+        struct Text_Plan_Cache
+        {
+            static constexpr size_t m_BucketCount = 64; // Power of two.
+
+            uint64_t m_Epoch = 0;
+            std::array<std::atomic<Text_Plan_Entry*>, m_BucketCount> m_Buckets {};
+            std::vector<std::unique_ptr<Text_Plan_Entry>> m_Entries; // Owns every entry in the buckets.
+        };
+
+        struct Reflection_State
+        {
+            Reflection_State();
+
+            Details::PublishedTable<Text_Codec_Table> m_CodecTable;
+            Details::PublishedTable<Text_Plan_Cache> m_PlanCache;
+        };
+
+        template <typename T>
+        void AddBuiltInCodec(Text_Codec_Table& codecTable)
+        {
+            codecTable.m_Codecs[Details::Resolve<T>()] = Serializer_Text_Reflection::MakeCodec<T>();
+        }
+
+        Reflection_State::Reflection_State()
+        {
+            std::unique_ptr<Text_Codec_Table> codecTable = std::make_unique<Text_Codec_Table>();
+            AddBuiltInCodec<bool>(*codecTable);
+            AddBuiltInCodec<char>(*codecTable);
+            AddBuiltInCodec<int8_t>(*codecTable);
+            AddBuiltInCodec<uint8_t>(*codecTable);
+            AddBuiltInCodec<int16_t>(*codecTable);
+            AddBuiltInCodec<uint16_t>(*codecTable);
+            AddBuiltInCodec<int32_t>(*codecTable);
+            AddBuiltInCodec<uint32_t>(*codecTable);
+            AddBuiltInCodec<int64_t>(*codecTable);
+            AddBuiltInCodec<uint64_t>(*codecTable);
+            AddBuiltInCodec<float>(*codecTable);
+            AddBuiltInCodec<double>(*codecTable);
+            AddBuiltInCodec<std::string>(*codecTable);
+            AddBuiltInCodec<Vector2>(*codecTable);
+            AddBuiltInCodec<Vector3>(*codecTable);
+
+            std::lock_guard<std::recursive_mutex> registrationLock(Details::GetRegistrationMutex());
+            Details::PublishTable(m_CodecTable, std::move(codecTable));
+        }
+
+        // Fetched before taking the registration mutex, which its construction takes while holding the static initialization guard.
+        Reflection_State& GetReflectionState()
+        {
+            static Reflection_State reflectionState;
+            return reflectionState;
+        }
+
+        size_t GetPlanBucketIndex(const TypeDescriptor* type)
+        {
+            return static_cast<size_t>((reinterpret_cast<uintptr_t>(type) >> 4) * 11400714819323198485ULL >> 16) & (Text_Plan_Cache::m_BucketCount - 1); // Descriptors are aligned, so their low bits are all alike.
+        }
+
+        const Text_Plan_Entry* FindPlanEntry(const Text_Plan_Cache& planCache, const TypeDescriptor* type)
+        {
+            for (const Text_Plan_Entry* planEntry = planCache.m_Buckets[GetPlanBucketIndex(type)].load(std::memory_order_acquire); planEntry; planEntry = planEntry->m_Next)
+            {
+                if (planEntry->m_Type == type)
+                {
+                    return planEntry;
+                }
+            }
+
+            return nullptr;
+        }
+
+        // Plans being built under the registration mutex. Published together once complete, so that lookups never come across one still being filled in.
+        struct Text_Plan_Build
+        {
+            const Text_Codec_Table& m_CodecTable;
+            const Text_Plan_Cache& m_PlanCache;
+            std::vector<std::unique_ptr<Text_Plan_Entry>> m_NewEntries;
+        };
+
+        // Depth first search for the chain of casts leading from a derived type to one of its (possibly indirect) bases.
+        bool FindBaseCasts(const TypeDescriptor* derivedType, const TypeDescriptor* baseType, std::vector<Base*>& baseCasts)
+        {
+            for (Base* base : derivedType->GetBases())
+            {
+                baseCasts.push_back(base);
+
+                if (base->GetType() == baseType || FindBaseCasts(base->GetType(), baseType, baseCasts))
+                {
+                    return true;
+                }
+
+                baseCasts.pop_back();
+            }
+
+            return false;
+        }
+
+        const Text_Binding_Plan* BuildBindingPlan(Text_Plan_Build& planBuild, const TypeDescriptor* type)
+        {
+            if (const Text_Plan_Entry* planEntry = FindPlanEntry(planBuild.m_PlanCache, type))
+            {
+                return planEntry->m_Plan.get();
+            }
+
+            for (const std::unique_ptr<Text_Plan_Entry>& newEntry : planBuild.m_NewEntries)
+            {
+                if (newEntry->m_Type == type)
+                {
+                    return newEntry->m_Plan.get();
+                }
+            }
+
+            // Added before walking the members so that nested references back to this type resolve to it rather than recursing forever.
+            Text_Plan_Entry& planEntry = *planBuild.m_NewEntries.emplace_back(std::make_unique<Text_Plan_Entry>());
+            planEntry.m_Type = type;
+
+            const std::vector<DataMember*>& dataMembers = type->GetDataMembers();
+            if (dataMembers.empty())
+            {
+                return nullptr;
+            }
+
+            Text_Binding_Plan* plan = (planEntry.m_Plan = std::make_unique<Text_Binding_Plan>()).get();
+            plan->m_Type = type;
+            plan->m_Bindings.reserve(dataMembers.size());
+
+            for (DataMember* dataMember : dataMembers)
+            {
+                Text_Binding binding;
+                binding.m_Name = dataMember->GetName();
+                binding.m_DataMember = dataMember;
+
+                if (plan->m_BindingIndices.count(binding.m_Name)) // Derived members come first and shadow base members of the same name.
+                {
+                    continue;
+                }
+
+                if (dataMember->GetParent() != type && !FindBaseCasts(type, dataMember->GetParent(), binding.m_BaseCasts))
+                {
+                    SPECULO_THROW_WARNING(SpeculoResult::SPECULO_WARNING_BEST_PRACTICES, "Skipping " + type->GetName() + "::" + binding.m_Name + " as its declaring class is not a registered base.");
+                    continue;
+                }
+
+                if (auto codecIterator = planBuild.m_CodecTable.m_Codecs.find(dataMember->GetType()); codecIterator != planBuild.m_CodecTable.m_Codecs.end())
+                {
+                    binding.m_Codec = &codecIterator->second;
+                }
+                else if (!(binding.m_Plan = BuildBindingPlan(planBuild, dataMember->GetType())))
+                {
+                    SPECULO_THROW_WARNING(SpeculoResult::SPECULO_WARNING_BEST_PRACTICES, "Skipping " + type->GetName() + "::" + binding.m_Name + " as its type has neither a text codec nor reflected data members.");
+                    continue;
+                }
+
+                plan->m_BindingIndices[binding.m_Name] = plan->m_Bindings.size();
+                plan->m_Bindings.push_back(std::move(binding));
+            }
+
+            return plan;
+        }
+
+        void* CastToOwner(void* object, const Text_Binding& binding)
+        {
+            for (Base* base : binding.m_BaseCasts)
+            {
+                object = base->Cast(object);
+            }
+
+            return object;
+        }
+    }
+
+    void Serializer_Text_Reflection::RegisterCodec(const TypeDescriptor* type, const Text_Codec& codec)
+    {
+        Reflection_State& reflectionState = GetReflectionState();
+
+        auto registrationLock = Details::LockRegistration();
+        if (!registrationLock)
+        {
+            return;
+        }
+
+        std::unique_ptr<Text_Codec_Table> codecTable = std::make_unique<Text_Codec_Table>(*reflectionState.m_CodecTable.m_Current.load(std::memory_order_relaxed));
+        codecTable->m_Codecs[type] = codec;
+        Details::PublishTable(reflectionState.m_CodecTable, std::move(codecTable));
+
+        std::unique_ptr<Text_Plan_Cache> planCache = std::make_unique<Text_Plan_Cache>(); // Plans hold pointers to codecs and may have skipped members of this type.
+        planCache->m_Epoch = Details::GetRegistrationEpoch().load(std::memory_order_relaxed);
+        Details::PublishTable(reflectionState.m_PlanCache, std::move(planCache));
+    }
+
+    const Text_Codec* Serializer_Text_Reflection::GetCodec(const TypeDescriptor* type)
+    {
+        const Text_Codec_Table& codecTable = *GetReflectionState().m_CodecTable.m_Current.load(std::memory_order_acquire);
+
+        auto codecIterator = codecTable.m_Codecs.find(type);
+        return codecIterator != codecTable.m_Codecs.end() ? &codecIterator->second : nullptr;
+    }
+
+    const Text_Binding_Plan* Serializer_Text_Reflection::GetBindingPlan(const TypeDescriptor* type)
+    {
+        Reflection_State& reflectionState = GetReflectionState();
+        auto getPlanCache = [&reflectionState]() -> Text_Plan_Cache& { return Details::GetPublishedTable(reflectionState.m_PlanCache, [](Text_Plan_Cache&) {}); }; // Filled in below as types are seen.
+
+        if (const Text_Plan_Entry* planEntry = FindPlanEntry(getPlanCache(), type))
+        {
+            return planEntry->m_Plan.get();
+        }
+
+        std::lock_guard<std::recursive_mutex> registrationLock(Details::GetRegistrationMutex());
+
+        Text_Plan_Cache& planCache = getPlanCache(); // Registration may have replaced it while waiting for the lock.
+        if (const Text_Plan_Entry* planEntry = FindPlanEntry(planCache, type)) // Or another thread may have just built the plan.
+        {
+            return planEntry->m_Plan.get();
+        }
+
+        if (Details::GetRegistrationFrozen().load(std::memory_order_relaxed)) // Codecs can no longer be registered and the epoch stays put, so these are final.
+        {
+            Details::ReleaseSupersededTables(reflectionState.m_CodecTable);
+            Details::ReleaseSupersededTables(reflectionState.m_PlanCache);
+        }
+
+        Text_Plan_Build planBuild { *reflectionState.m_CodecTable.m_Current.load(std::memory_order_relaxed), planCache, {} };
+        const Text_Binding_Plan* plan = BuildBindingPlan(planBuild, type);
+
+        for (std::unique_ptr<Text_Plan_Entry>& newEntry : planBuild.m_NewEntries)
+        {
+            std::atomic<Text_Plan_Entry*>& bucket = planCache.m_Buckets[GetPlanBucketIndex(newEntry->m_Type)];
+            newEntry->m_Next = bucket.load(std::memory_order_relaxed);
+            bucket.store(newEntry.get(), std::memory_order_release);
+
+            planCache.m_Entries.push_back(std::move(newEntry));
+        }
+
+        return plan;
+    }
+
+    bool Serializer_Text_Reflection::Emit(YAML::Emitter& emitter, const void* object, const TypeDescriptor* type)
+    {
+        if (const Text_Codec* codec = GetCodec(type))
+        {
+            codec->m_Emit(emitter, object);
+            return true;
+        }
+
+        if (const Text_Binding_Plan* plan = GetBindingPlan(type))
+        {
+            EmitObject(emitter, const_cast<void*>(object), *plan); // Only ever read from. Getters simply take non-const objects.
+            return true;
+        }
+
+        return false;
+    }
+
+    bool Serializer_Text_Reflection::Decode(const YAML::Node& node, void* object, const TypeDescriptor* type, std::vector<std::string>& failedMembers)
+    {
+        if (const Text_Codec* codec = GetCodec(type))
+        {
+            if (!codec->m_Decode(node, object))
+            {
+                failedMembers.emplace_back();
+                return false;
+            }
+
+            return true;
+        }
+
+        if (const Text_Binding_Plan* plan = GetBindingPlan(type))
+        {
+            const size_t failureCount = failedMembers.size();
+            DecodeObject(node, object, *plan, "", failedMembers);
+
+            return failedMembers.size() == failureCount;
+        }
+
+        failedMembers.emplace_back();
+        return false;
+    }
+
+    void Serializer_Text_Reflection::EmitObject(YAML::Emitter& emitter, void* object, const Text_Binding_Plan& plan)
+    {
+        emitter << YAML::BeginMap;
+
+        for (const Text_Binding& binding : plan.m_Bindings)
+        {
+            void* owner = CastToOwner(object, binding);
+            emitter << YAML::Key << binding.m_Name << YAML::Value;
+
+            if (void* address = binding.m_DataMember->GetAddress(owner))
+            {
+                binding.m_Codec ? binding.m_Codec->m_Emit(emitter, address) : EmitObject(emitter, address, *binding.m_Plan);
+            }
+            else
+            {
+                Any value = binding.m_DataMember->Get(AnyRef(owner, binding.m_DataMember->GetParent()));
+                binding.m_Codec ? binding.m_Codec->m_Emit(emitter, value.Get()) : EmitObject(emitter, value.Get(), *binding.m_Plan);
+            }
+        }
+
+        emitter << YAML::EndMap;
+    }
+
+    void Serializer_Text_Reflection::DecodeObject(const YAML::Node& node, void* object, const Text_Binding_Plan& plan, const std::string& path, std::vector<std::string>& failedMembers)
+    {
+        if (!node.IsMap())
+        {
+            failedMembers.push_back(path.empty() ? path : path.substr(0, path.size() - 1)); // Strip the trailing separator.
+            return;
+        }
+
+        // Walk the document rather than the plan, so that each key costs a single hash lookup. Keys of members that no longer exist are skipped.
+        for (YAML::const_iterator nodeIterator = node.begin(); nodeIterator != node.end(); nodeIterator++)
+        {
+            auto bindingIterator = plan.m_BindingIndices.find(nodeIterator->first.Scalar());
+            if (bindingIterator == plan.m_BindingIndices.end())
+            {
+                continue;
+            }
+
+            const Text_Binding& binding = plan.m_Bindings[bindingIterator->second];
+            const YAML::Node valueNode = nodeIterator->second; // A copy, as the iterator hands out a temporary proxy.
+            void* owner = CastToOwner(object, binding);
+            bool isDecoded = true;
+
+            if (void* address = binding.m_DataMember->GetAddress(owner)) // Direct field access, which never throws.
+            {
+                if (binding.m_Codec)
+                {
+                    isDecoded = binding.m_Codec->m_Decode(valueNode, address);
+                }
+                else
+                {
+                    DecodeObject(valueNode, address, *binding.m_Plan, path + binding.m_Name + ".", failedMembers);
+                }
+            }
+            else try // Setters report type mismatches with BadCastException.
+            {
+                if (binding.m_Codec)
+                {
+                    Any value = binding.m_Codec->m_DecodeAny(valueNode);
+                    isDecoded = static_cast<bool>(value);
+
+                    if (isDecoded)
+                    {
+                        binding.m_DataMember->Set(AnyRef(owner, binding.m_DataMember->GetParent()), value);
+                    }
+                }
+                else // Nested object behind a getter/setter pair: Fetch a copy, decode into it and write it back.
+                {
+                    AnyRef ownerRef(owner, binding.m_DataMember->GetParent());
+                    Any value = binding.m_DataMember->Get(ownerRef);
+
+                    DecodeObject(valueNode, value.Get(), *binding.m_Plan, path + binding.m_Name + ".", failedMembers);
+                    binding.m_DataMember->Set(ownerRef, value);
+                }
+            }
+            catch (std::exception&)
+            {
+                isDecoded = false;
+            }
+
+            if (!isDecoded)
+            {
+                failedMembers.push_back(path + binding.m_Name);
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Serializer_Text_Utilities.h"
+#include "RTTI/Reflect.hpp"
+
+namespace Speculo
+{
+    // Reads and writes a single value of one concrete type. Every leaf type (ints, floats, strings, vectors...) needs one,
+    // while any type registered through Reflect<T>().AddDataMember(...) is walked member by member instead.
+    struct Text_Codec
+    {
+        void (*m_Emit)(YAML::Emitter& emitter, const void* value) = nullptr;
+        bool (*m_Decode)(const YAML::Node& node, void* value) = nullptr;
+        Any (*m_DecodeAny)(const YAML::Node& node) = nullptr; // For members only reachable through a setter.
+    };
+
+    struct Text_Binding_Plan;
+
+    struct Text_Binding
+    {
+        std::string m_Name;
+        DataMember* m_DataMember = nullptr;
+        std::vector<Base*> m_BaseCasts;           // Casts from the planned type down to the base class declaring this member, if any.
+
+        const Text_Codec* m_Codec = nullptr;      // Set for leaf types.
+        const Text_Binding_Plan* m_Plan = nullptr; // Set for nested reflected types.
+    };
+
+    // The flattened list of members of a reflected type, resolved once and cached per type descriptor.
+    struct Text_Binding_Plan
+    {
+        const TypeDescriptor* m_Type = nullptr;
+        std::vector<Text_Binding> m_Bindings;
+        std::unordered_map<std::string, size_t> m_BindingIndices; // Member name -> index into m_Bindings.
+    };
+
+    class Serializer_Text_Reflection
+    {
+    public:
+        // T needs a YAML::convert<T> specialization and an operator<< for YAML::Emitter, same as SerializeProperty/DeserializeProperty.
+        template <typename T>
+        static void RegisterCodec()
+        {
+            RegisterCodec(Details::Resolve<T>(), MakeCodec<T>());
+        }
+
+        template <typename T>
+        static Text_Codec MakeCodec()
+        {
+            Text_Codec codec;
+            codec.m_Emit = [](YAML::Emitter& emitter, const void* value) { emitter << *static_cast<const T*>(value); };
+            codec.m_Decode = [](const YAML::Node& node, void* value) { return TryDecode(node, *static_cast<T*>(value)); };
+            codec.m_DecodeAny = [](const YAML::Node& node)
+            {
+                T value{};
+                return TryDecode(node, value) ? Any(std::move(value)) : Any();
+            };
+
+            return codec;
+        }
+
+        // Codecs are registered along with types, i.e. before Freeze().
+        static void RegisterCodec(const TypeDescriptor* type, const Text_Codec& codec);
+        static const Text_Codec* GetCodec(const TypeDescriptor* type);
+
+        // Returns nullptr if the type has no reflected data members. Plans are built on first use and shared from then on,
+        // so codecs should be registered up front: registering one rebuilds every cached plan.
+        // Codecs and plans are looked up without locking. Like reflection metadata, those fetched before Freeze() must be fetched again afterwards.
+        static const Text_Binding_Plan* GetBindingPlan(const TypeDescriptor* type);
+
+        static bool Emit(YAML::Emitter& emitter, const void* object, const TypeDescriptor* type);
+
+        // Never throws. Failures are appended to failedMembers as dotted member paths (empty for the object itself) rather than reported immediately.
+        static bool Decode(const YAML::Node& node, void* object, const TypeDescriptor* type, std::vector<std::string>& failedMembers);
+
+    private:
+        static void EmitObject(YAML::Emitter& emitter, void* object, const Text_Binding_Plan& plan);
+        static void DecodeObject(const YAML::Node& node, void* object, const Text_Binding_Plan& plan, const std::string& path, std::vector<std::string>& failedMembers);
+    };
+}
\ No newline at end of file
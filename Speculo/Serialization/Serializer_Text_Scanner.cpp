@@ -0,0 +1,425 @@
+#include "SpeculoPCH.h"
+#include "Serializer_Text_Scanner.h"
+
+namespace Speculo
+{
+    namespace
+    {
+        enum class Scan_State
+        {
+            TopLevel,
+            Metadata,
+            Data
+        };
+
+        std::string_view TrimValue(std::string_view value)
+        {
+            const size_t valueBegin = value.find_first_not_of(' ');
+            if (valueBegin == std::string_view::npos)
+            {
+                return {};
+            }
+
+            value.remove_prefix(valueBegin);
+
+            if (value[0] == '#') // The whole remainder is a comment.
+            {
+                return {};
+            }
+
+            if (const size_t commentBegin = value.find(" #"); commentBegin != std::string_view::npos)
+            {
+                value = value.substr(0, commentBegin);
+            }
+
+            return value.substr(0, value.find_last_not_of(' ') + 1);
+        }
+
+        // Aliases can only be resolved against anchors within the same parse, which sections parsed on their own would not have.
+        // Errs on the side of caution: The same characters within quoted scalars make us fall back as well.
+        bool HasAnchorOrAlias(std::string_view entry)
+        {
+            for (std::string_view indicator : { ": &", ": *", "- &", "- *", "[&", "[*", ", &", ", *" })
+            {
+                if (entry.find(indicator) != std::string_view::npos)
+                {
+                    return true;
+                }
+            }
+
+            return entry[0] == '&' || entry[0] == '*';
+        }
+
+        bool IsSectionFound(const Text_Section* closedSection, std::string_view sectionKey, const Text_Document_Index& documentIndex, bool hasMetadata)
+        {
+            return !sectionKey.empty() && hasMetadata && !documentIndex.m_DataSections.empty() && closedSection == &documentIndex.m_DataSections.back() && closedSection->m_Key == sectionKey;
+        }
+    }
+
+    bool Serializer_Text_Scanner::ScanDocument(std::string_view document, Text_Document_Index& documentIndex)
+    {
+        return ScanSections(document, true, {}, documentIndex) == Text_Scan_Result::Found;
+    }
+
+    Text_Scan_Result Serializer_Text_Scanner::FindDataSection(std::string_view documentPrefix, bool isEndOfDocument, std::string_view sectionKey, Text_Section& section)
+    {
+        Text_Document_Index documentIndex;
+        const Text_Scan_Result scanResult = ScanSections(documentPrefix, isEndOfDocument, sectionKey, documentIndex);
+
+        if (scanResult == Text_Scan_Result::Found)
+        {
+            section = std::move(documentIndex.m_DataSections.back());
+        }
+
+        return scanResult;
+    }
+
+    // With an empty sectionKey, indexes the whole document. Otherwise returns as soon as the Data entry keyed sectionKey is closed off.
+    Text_Scan_Result Serializer_Text_Scanner::ScanSections(std::string_view document, bool isEndOfDocument, std::string_view sectionKey, Text_Document_Index& documentIndex)
+    {
+        documentIndex = Text_Document_Index();
+
+        bool isEndOfScan = isEndOfDocument; // Also set by document end markers.
+        Scan_State scanState = Scan_State::TopLevel;
+        Text_Section* openSection = nullptr; // Section whose end has not been found yet.
+        bool hasMetadata = false;
+        bool hasData = false;
+        size_t dataIndent = 0;
+
+        size_t lineBegin = 0;
+        while (lineBegin < document.size())
+        {
+            size_t lineEnd = document.find('\n', lineBegin);
+            if (lineEnd == std::string_view::npos && !isEndOfDocument) // The last line may have been cut short.
+            {
+                return Text_Scan_Result::Incomplete;
+            }
+
+            const size_t nextLine = lineEnd == std::string_view::npos ? document.size() : lineEnd + 1;
+            lineEnd = lineEnd == std::string_view::npos ? document.size() : lineEnd;
+
+            std::string_view line = document.substr(lineBegin, lineEnd - lineBegin);
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.remove_suffix(1);
+            }
+
+            const size_t indent = line.find_first_not_of(' ');
+            if (indent == std::string_view::npos || line[indent] == '#') // Blank lines and comments belong to whatever precedes them.
+            {
+                lineBegin = nextLine;
+                continue;
+            }
+
+            if (line[indent] == '\t')
+            {
+                return Text_Scan_Result::Unsupported;
+            }
+
+            std::string key;
+            std::string_view value;
+
+            if (indent == 0)
+            {
+                if (openSection)
+                {
+                    openSection->m_End = lineBegin;
+
+                    if (IsSectionFound(openSection, sectionKey, documentIndex, hasMetadata))
+                    {
+                        return Text_Scan_Result::Found;
+                    }
+
+                    openSection = nullptr;
+                }
+
+                if (line.substr(0, 3) == "---" || line.substr(0, 3) == "...") // Document markers. We only ever read the first document.
+                {
+                    if (hasMetadata || hasData)
+                    {
+                        isEndOfScan = true;
+                        break;
+                    }
+
+                    lineBegin = nextLine;
+                    continue;
+                }
+
+                if (!ParseKey(line, key, value))
+                {
+                    return Text_Scan_Result::Unsupported;
+                }
+
+                if (key == "Metadata")
+                {
+                    documentIndex.m_Metadata.m_Key = key;
+                    documentIndex.m_Metadata.m_Begin = lineBegin;
+                    openSection = &documentIndex.m_Metadata;
+                    scanState = Scan_State::Metadata;
+                    hasMetadata = true;
+                }
+                else if (key == "Data")
+                {
+                    hasData = true;
+
+                    if (value.empty())
+                    {
+                        scanState = Scan_State::Data;
+                    }
+                    else if (value == "{}") // Nothing was serialized.
+                    {
+                        scanState = Scan_State::TopLevel;
+                    }
+                    else // Flow style Data map.
+                    {
+                        return Text_Scan_Result::Unsupported;
+                    }
+                }
+                else
+                {
+                    scanState = Scan_State::TopLevel;
+                }
+            }
+            else if (scanState == Scan_State::Data)
+            {
+                dataIndent = dataIndent == 0 ? indent : dataIndent;
+
+                if (indent < dataIndent)
+                {
+                    return Text_Scan_Result::Unsupported;
+                }
+
+                const std::string_view entry = line.substr(indent);
+                if (HasAnchorOrAlias(entry))
+                {
+                    return Text_Scan_Result::Unsupported;
+                }
+
+                const bool isContinuation = indent > dataIndent || entry[0] == '-'; // Nested lines, or a sequence written at its parent key's indentation.
+
+                if (!isContinuation && entry != "{}")
+                {
+                    if (!ParseKey(entry, key, value))
+                    {
+                        return Text_Scan_Result::Unsupported;
+                    }
+
+                    if (openSection)
+                    {
+                        openSection->m_End = lineBegin;
+
+                        if (IsSectionFound(openSection, sectionKey, documentIndex, hasMetadata))
+                        {
+                            return Text_Scan_Result::Found;
+                        }
+                    }
+
+                    Text_Section& section = documentIndex.m_DataSections.emplace_back();
+                    section.m_Key = std::move(key);
+                    section.m_Begin = lineBegin;
+                    openSection = &section;
+                }
+            }
+
+            lineBegin = nextLine;
+        }
+
+        if (!isEndOfScan) // Whatever follows may still belong to the open section.
+        {
+            return Text_Scan_Result::Incomplete;
+        }
+
+        if (openSection)
+        {
+            openSection->m_End = lineBegin;
+
+            if (IsSectionFound(openSection, sectionKey, documentIndex, hasMetadata))
+            {
+                return Text_Scan_Result::Found;
+            }
+        }
+
+        if (!hasMetadata || !hasData)
+        {
+            return Text_Scan_Result::Unsupported;
+        }
+
+        return sectionKey.empty() ? Text_Scan_Result::Found : Text_Scan_Result::NotFound;
+    }
+
+    bool Serializer_Text_Scanner::ParseKey(std::string_view line, std::string& key, std::string_view& value)
+    {
+        size_t keyEnd = 0;
+
+        if (line[0] == '\'') // Single quoted keys escape quotes by doubling them.
+        {
+            key.clear();
+
+            size_t index = 1;
+            for (; index < line.size(); index++)
+            {
+                if (line[index] == '\'')
+                {
+                    if (index + 1 < line.size() && line[index + 1] == '\'')
+                    {
+                        key.push_back('\'');
+                        index++;
+                        continue;
+                    }
+
+                    break;
+                }
+
+                key.push_back(line[index]);
+            }
+
+            if (index >= line.size())
+            {
+                return false;
+            }
+
+            keyEnd = line.find_first_not_of(' ', index + 1);
+        }
+        else if (line[0] == '"')
+        {
+            const size_t quoteEnd = line.find('"', 1);
+            if (quoteEnd == std::string_view::npos || line.substr(1, quoteEnd - 1).find('\\') != std::string_view::npos) // Escape sequences are left to the full parser.
+            {
+                return false;
+            }
+
+            key.assign(line.substr(1, quoteEnd - 1));
+            keyEnd = line.find_first_not_of(' ', quoteEnd + 1);
+        }
+        else
+        {
+            if (std::string_view("?-[]{}&*!|>%@`,").find(line[0]) != std::string_view::npos) // Indicators we do not attempt to interpret.
+            {
+                return false;
+            }
+
+            size_t colon = line.find(':');
+            while (colon != std::string_view::npos && colon + 1 < line.size() && line[colon + 1] != ' ')
+            {
+                colon = line.find(':', colon + 1);
+            }
+
+            if (colon == std::string_view::npos || colon == 0)
+            {
+                return false;
+            }
+
+            key.assign(line.substr(0, line.find_last_not_of(' ', colon - 1) + 1));
+            keyEnd = colon;
+        }
+
+        if (keyEnd == std::string_view::npos || line[keyEnd] != ':' || (keyEnd + 1 < line.size() && line[keyEnd + 1] != ' '))
+        {
+            return false;
+        }
+
+        value = TrimValue(line.substr(keyEnd + 1));
+        return true;
+    }
+
+    Text_Scan_Result Serializer_Text_Scanner::FindMetadata(std::string_view documentPrefix, bool isEndOfDocument, std::string_view& metadata)
+    {
+        const Text_Scan_Result truncatedResult = isEndOfDocument ? Text_Scan_Result::NotFound : Text_Scan_Result::Incomplete;
+        constexpr std::string_view metadataKey = "Metadata";
+
+        // Find the key itself, skipping over any mention of it that is not followed by a colon (i.e. within a comment).
+        size_t keyBegin = documentPrefix.find(metadataKey);
+        size_t colon = std::string_view::npos;
+
+        while (keyBegin != std::string_view::npos)
+        {
+            colon = documentPrefix.find_first_not_of("\"' ", keyBegin + metadataKey.size());
+            if (colon != std::string_view::npos && documentPrefix[colon] == ':')
+            {
+                break;
+            }
+
+            keyBegin = documentPrefix.find(metadataKey, keyBegin + metadataKey.size());
+        }
+
+        if (keyBegin == std::string_view::npos || colon == std::string_view::npos)
+        {
+            return truncatedResult;
+        }
+
+        const size_t valueBegin = documentPrefix.find_first_not_of(' ', colon + 1);
+        if (valueBegin == std::string_view::npos)
+        {
+            return truncatedResult;
+        }
+
+        if (documentPrefix[valueBegin] == '{') // Flow style: Match braces up to the end of the map, ignoring any within quoted scalars.
+        {
+            size_t depth = 0;
+            char quote = '\0';
+
+            for (size_t index = valueBegin; index < documentPrefix.size(); index++)
+            {
+                const char character = documentPrefix[index];
+
+                if (quote != '\0')
+                {
+                    quote = character == quote ? '\0' : quote; // Escaped quotes only ever end up toggling twice.
+                }
+                else if (character == '"' || character == '\'')
+                {
+                    quote = character;
+                }
+                else if (character == '{')
+                {
+                    depth++;
+                }
+                else if (character == '}' && --depth == 0)
+                {
+                    metadata = documentPrefix.substr(valueBegin, index + 1 - valueBegin);
+                    return Text_Scan_Result::Found;
+                }
+            }
+
+            return truncatedResult;
+        }
+
+        // Block style: The value spans every following line indented deeper than the key.
+        const size_t lineBegin = documentPrefix.find_last_of('\n', keyBegin);
+        const size_t keyIndent = keyBegin - (lineBegin == std::string_view::npos ? 0 : lineBegin + 1);
+
+        const size_t blockBegin = documentPrefix.find('\n', valueBegin);
+        if (blockBegin == std::string_view::npos)
+        {
+            return truncatedResult;
+        }
+
+        size_t blockLine = blockBegin + 1;
+        while (blockLine < documentPrefix.size())
+        {
+            const size_t blockLineEnd = documentPrefix.find('\n', blockLine);
+            if (blockLineEnd == std::string_view::npos && !isEndOfDocument) // The last line may have been cut short.
+            {
+                return Text_Scan_Result::Incomplete;
+            }
+
+            const std::string_view line = documentPrefix.substr(blockLine, blockLineEnd == std::string_view::npos ? std::string_view::npos : blockLineEnd - blockLine);
+            const size_t indent = line.find_first_not_of(' ');
+
+            if (indent != std::string_view::npos && line[indent] != '\r' && line[indent] != '#' && indent <= keyIndent)
+            {
+                break;
+            }
+
+            blockLine = blockLineEnd == std::string_view::npos ? documentPrefix.size() : blockLineEnd + 1;
+        }
+
+        if (blockLine >= documentPrefix.size() && !isEndOfDocument)
+        {
+            return Text_Scan_Result::Incomplete;
+        }
+
+        metadata = documentPrefix.substr(blockBegin + 1, blockLine - blockBegin - 1);
+        return metadata.empty() ? Text_Scan_Result::NotFound : Text_Scan_Result::Found;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Speculo
+{
+    // Byte range [m_Begin, m_End) of a single top-level entry within the document. The range covers the key line and every nested line belonging to it.
+    struct Text_Section
+    {
+        std::string m_Key;
+        size_t m_Begin = 0;
+        size_t m_End = 0;
+    };
+
+    enum class Text_Scan_Result
+    {
+        Found,
+        Incomplete, // Ran out of input before the end of what was being looked for. Retry with more of the document.
+        NotFound,
+        Unsupported // The document has a structure the scan does not understand. Fall back to a full parse.
+    };
+
+    struct Text_Document_Index
+    {
+        Text_Section m_Metadata;
+        std::vector<Text_Section> m_DataSections;
+    };
+
+    // A lightweight structural scan over block style documents written by Serializer_Text. It only looks at indentation and keys,
+    // never at values, which makes it a fraction of the cost of a full YAML parse. Anything it does not recognize (flow style documents,
+    // complex keys, escaped keys, anchors and aliases) makes the scan fail, upon which callers are expected to fall back to a full parse.
+    class Serializer_Text_Scanner
+    {
+    public:
+        static bool ScanDocument(std::string_view document, Text_Document_Index& documentIndex);
+
+        // Same scan, but stops as soon as the end of the Data entry keyed sectionKey is known, so that only the part of the document
+        // up to it needs to be read. documentPrefix may end anywhere, a trailing partial line is left for the next call.
+        static Text_Scan_Result FindDataSection(std::string_view documentPrefix, bool isEndOfDocument, std::string_view sectionKey, Text_Section& section);
+
+        // Locates the value of the Metadata key within the leading bytes of a document, in either block or flow style. As Metadata is always
+        // written first, only the first occurrence of the key is considered. On success, metadata is a slice that YAML::Load() parses into a map.
+        static Text_Scan_Result FindMetadata(std::string_view documentPrefix, bool isEndOfDocument, std::string_view& metadata);
+
+    private:
+        static Text_Scan_Result ScanSections(std::string_view document, bool isEndOfDocument, std::string_view sectionKey, Text_Document_Index& documentIndex);
+        static bool ParseKey(std::string_view line, std::string& key, std::string_view& value);
+    };
+}
\ No newline at end of file
@@ -24,9 +24,7 @@ namespace YAML
                 return false;
             }
 
-            rhs.x = node[0].as<float>();
-            rhs.y = node[1].as<float>();
-            return true;
+            return convert<float>::decode(node[0], rhs.x) && convert<float>::decode(node[1], rhs.y); // Unlike as<float>(), never throws.
         }
     };
 
@@ -49,16 +47,34 @@ namespace YAML
                 return false;
             }
 
-            rhs.x = node[0].as<float>();
-            rhs.y = node[1].as<float>();
-            rhs.z = node[2].as<float>();
-            return true;
+            return convert<float>::decode(node[0], rhs.x) && convert<float>::decode(node[1], rhs.y) && convert<float>::decode(node[2], rhs.z);
         }
     };
 }
 
 namespace Speculo
 {
+    // YAML::Node::as<T>() reports a failed conversion by throwing, which is far too slow when migrating data full of mismatches.
+    // convert<T>::decode() reports it through its return value instead and never throws for scalars. Only containers may still throw
+    // from converting their elements, which is caught here as a last resort.
+    template <typename T>
+    bool TryDecode(const YAML::Node& node, T& value) noexcept
+    {
+        if (!node.IsDefined())
+        {
+            return false;
+        }
+
+        try
+        {
+            return YAML::convert<T>::decode(node, value);
+        }
+        catch (std::exception&)
+        {
+            return false;
+        }
+    }
+
     inline YAML::Emitter& operator<<(YAML::Emitter& outStream, const Speculo::Vector2& targetVector)
     {
         outStream << YAML::Flow;
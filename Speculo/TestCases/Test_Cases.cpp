@@ -1,10 +1,18 @@
 #include "SpeculoPCH.h"
 #include "../Serialization/Serializer_Text.h"
 #include "../Serialization/Serializer_Binary.h"
+#include "../Serialization/Serializer_Batch.h"
+#include "../Serialization/Serializer_Catalog.h"
+#include "../Serialization/Serializer_Text_Reflection.h"
+#include "../Core/ThreadPool.h"
 #include "Material.h"
 #include "Math.h"
 #include "RTTI/Reflect.hpp"
+#include "RTTI/ReflectionImage.hpp"
+#include "Reflection/StaticReflect.h"
 #include "Delegates/Signal.hpp"
+#include <filesystem>
+#include <thread>
 
 using namespace Speculo;
 
@@ -14,6 +22,11 @@ void Print(const T& t)
     std::cout << Speculo::Resolve<T>()->GetName() << ": " << t << std::endl;
 }
 
+void Check(bool condition, const std::string& description)
+{
+    std::cout << (condition ? "Passed: " : "FAILED: ") << description << "\n";
+}
+
 Material CreateDummyMaterial(const std::string& resourcePath)
 {
     Material dummyMaterial(resourcePath);
@@ -40,6 +53,23 @@ void TextSerializationTest()
     testCase.EndSerialization();
 }
 
+void StreamedSerializationTest()
+{
+    // Larger than the output buffer, so most of the document is flushed to disk before EndSerialization.
+    Speculo::Serializer_Text serializer(Speculo::Serializer_Operation_Type::Serialization, "../UnitTests/Streamed_Test", "Streamed_Test");
+    for (int propertyIndex = 0; propertyIndex < 100000; propertyIndex++)
+    {
+        serializer.SerializeProperty("Property_" + std::to_string(propertyIndex), propertyIndex);
+    }
+    serializer.EndSerialization();
+
+    Speculo::Serializer_Text deserializer(Speculo::Serializer_Operation_Type::Deserialization, "../UnitTests/Streamed_Test", "Streamed_Test");
+    const int lastValue = deserializer.DeserializePropertyAs<int>("Property_99999");
+    deserializer.EndDeserialization();
+
+    Check(lastValue == 99999, "Streamed documents larger than the output buffer are written out whole");
+}
+
 void TextDeserializationTest()
 {
     int playerSpeed;
@@ -97,6 +127,582 @@ void MaterialDeserializationTest()
     materialDeserialization.EndDeserialization();
 }
 
+void LazyDeserializationTest()
+{
+    // Only the section we ask for gets parsed.
+    Speculo::Serializer_Text materialDeserialization(Speculo::Serializer_Operation_Type::Deserialization, "../UnitTests/Material_Test", "Material", Speculo::Serializer_Text_Flags_Lazy);
+    std::cout << materialDeserialization.DeserializePropertyAs<float>("Material_Roughness_Multiplier") << "\n";
+    materialDeserialization.EndDeserialization();
+}
+
+void FailedDeserializationTest()
+{
+    // Missing and mistyped properties are recorded instead of thrown, and never hand back garbage.
+    Speculo::Serializer_Text testCases(Speculo::Serializer_Operation_Type::Deserialization, "../UnitTests/Feature_Tests.yml", "Feature_Tests");
+    const int missingValue = testCases.DeserializePropertyAs<int>("Player_Missing");
+    const float defaultedValue = testCases.DeserializePropertyAs<float>("Player_Location", 2.5f);
+    const size_t errorCount = testCases.GetDeserializationErrors().size();
+    testCases.EndDeserialization();
+
+    Check(missingValue == 0 && defaultedValue == 2.5f && errorCount == 2, "Failed properties are recorded and fall back to defaults");
+}
+
+void BatchDeserializationTest()
+{
+    Speculo::Serializer_Batch batch;
+
+    batch.AddTextFile("../UnitTests/Feature_Tests.yml", "Feature_Tests", [](Speculo::Serializer_Text& serializer)
+    {
+        std::cout << serializer.DeserializePropertyAs<int>("Player_Speed") << "\n";
+    });
+
+    batch.AddTextFile("../UnitTests/Material_Test", "Material", [](Speculo::Serializer_Text& serializer)
+    {
+        std::cout << serializer.DeserializePropertyAs<std::string>("Material_Color_Path") << "\n";
+    });
+
+    batch.AddBinaryFile("../UnitTests/BinaryTest", "Binary_Test", [](Speculo::Serializer_Binary& serializer)
+    {
+        std::cout << serializer.DeserializePropertyAs<int>() << "\n";
+    });
+
+    batch.Load(Speculo::Serializer_Delivery_Order::Submission);
+}
+
+void ThreadPoolExceptionTest()
+{
+    // A throwing job must neither take the process down nor leave Wait() blocked.
+    Speculo::ThreadPool threadPool(2);
+    threadPool.Submit([](uint32_t) { throw std::runtime_error("Job_Failure"); });
+    threadPool.Submit([](uint32_t) { });
+
+    bool isRethrown = false;
+    try
+    {
+        threadPool.Wait();
+    }
+    catch (const std::runtime_error&)
+    {
+        isRethrown = true;
+    }
+
+    Check(isRethrown, "ThreadPool::Wait rethrows a job's exception");
+}
+
+struct Test_Transform
+{
+    Speculo::Vector3 m_Position;
+    Speculo::Vector3 m_Scale = Speculo::Vector3(1, 1, 1);
+};
+
+struct Test_Player
+{
+    std::string m_Name;
+    int m_Health = 0;
+    Test_Transform m_Transform;
+
+    int GetLevel() const { return m_Level; }
+    void SetLevel(int level) { m_Level = level; }
+
+private:
+    int m_Level = 0;
+};
+
+struct Test_Hero : Test_Player
+{
+    int m_Mana = 0;
+};
+
+struct Test_Fragile
+{
+    Test_Fragile(int value) : m_Value(value)
+    {
+        if (m_FailAfter >= 0 && m_FailAfter-- == 0)
+        {
+            throw std::runtime_error("Construction_Failure");
+        }
+
+        m_LiveCount++;
+    }
+
+    Test_Fragile(const Test_Fragile& other) : m_Value(other.m_Value) { m_LiveCount++; }
+    ~Test_Fragile() { m_LiveCount--; }
+
+    int m_Value = 0;
+
+    static inline int m_FailAfter = -1; // Constructions left before one throws, or -1 for never.
+    static inline int m_LiveCount = 0;
+};
+
+struct Test_Feet
+{
+    double m_Value = 0.0;
+};
+
+struct Test_Meters
+{
+    double m_Value = 0.0;
+
+    operator Test_Feet() const { return Test_Feet{ m_Value * 3.25 }; }
+};
+
+Test_Fragile MakeFragile(Test_Feet feet)
+{
+    return Test_Fragile(static_cast<int>(feet.m_Value));
+}
+
+void RegisterReflectedTestTypes()
+{
+    Speculo::Reflect<Test_Transform>("Test_Transform").AddDataMember(&Test_Transform::m_Position, "Position").AddDataMember(&Test_Transform::m_Scale, "Scale");
+    Speculo::Reflect<Test_Player>("Test_Player").AddDataMember(&Test_Player::m_Name, "Name").AddDataMember(&Test_Player::m_Health, "Health")
+                                                .AddDataMember(&Test_Player::m_Transform, "Transform").AddDataMember<&Test_Player::SetLevel, &Test_Player::GetLevel>("Level")
+                                                .AddMemberFunction(&Test_Player::GetLevel, "GetLevel").AddMemberFunction(&Test_Player::SetLevel, "SetLevel");
+    Speculo::Reflect<Test_Hero>("Test_Hero").AddBase<Test_Player>().AddDataMember(&Test_Hero::m_Mana, "Mana");
+    Speculo::Reflect<Test_Fragile>("Test_Fragile").AddDataMember(&Test_Fragile::m_Value, "Value").AddConstructor<int>().AddConstructor(&MakeFragile);
+    Speculo::Reflect<Test_Feet>("Test_Feet").AddDataMember(&Test_Feet::m_Value, "Value");
+    Speculo::Reflect<Test_Meters>("Test_Meters").AddDataMember(&Test_Meters::m_Value, "Value").AddConversion<Test_Feet>();
+}
+
+void ReflectedSerializationTest()
+{
+    Test_Player player;
+    player.m_Name = "Speculo";
+    player.m_Health = 80;
+    player.m_Transform.m_Position = Speculo::Vector3(1, 2, 3);
+    player.SetLevel(7);
+
+    Speculo::Serializer_Text serializer(Speculo::Serializer_Operation_Type::Serialization, "../UnitTests/Reflection_Test", "Reflection_Test");
+    serializer.SerializeReflectedProperty("Player", player);
+    serializer.EndSerialization();
+
+    Test_Player loadedPlayer;
+    Speculo::Serializer_Text deserializer(Speculo::Serializer_Operation_Type::Deserialization, "../UnitTests/Reflection_Test", "Reflection_Test");
+    const Speculo::SpeculoResult result = deserializer.DeserializeReflectedProperty("Player", &loadedPlayer);
+    deserializer.EndDeserialization();
+
+    Check(result == Speculo::SpeculoResult::SPECULO_SUCCESS && loadedPlayer.m_Name == "Speculo" && loadedPlayer.m_Health == 80 && loadedPlayer.m_Transform.m_Position.z == 3.0f &&
+          loadedPlayer.m_Transform.m_Scale.x == 1.0f && loadedPlayer.GetLevel() == 7, "Reflected types round trip through Serializer_Text");
+
+    // Serializations running elsewhere keep using the plan they were handed while codecs are registered.
+    const Speculo::Text_Binding_Plan* playerPlan = Speculo::Serializer_Text_Reflection::GetBindingPlan(Speculo::Resolve<Test_Player>());
+    Speculo::Serializer_Text_Reflection::RegisterCodec<Speculo::Vector2>();
+    Check(playerPlan->m_Type == Speculo::Resolve<Test_Player>() && playerPlan->m_Bindings.size() == 4, "Binding plans outlive codec registration");
+}
+
+void SectionSerializationTest()
+{
+    // Sections are built on worker threads and stitched back together in submission order.
+    Speculo::Serializer_Text serializer(Speculo::Serializer_Operation_Type::Serialization, "../UnitTests/Section_Test", "Section_Test");
+    serializer.SerializeProperty("Scene_Name", std::string("Section_Scene"));
+    for (int sectionIndex = 0; sectionIndex < 8; sectionIndex++)
+    {
+        serializer.SerializeSection("Section_" + std::to_string(sectionIndex), [sectionIndex](Speculo::Serializer_Text_Section& section)
+        {
+            section.SerializeProperty("Index", sectionIndex);
+            section.SerializeProperty("Count", sectionIndex * 2);
+        });
+    }
+    serializer.EndSerialization();
+
+    Speculo::Serializer_Text deserializer(Speculo::Serializer_Operation_Type::Deserialization, "../UnitTests/Section_Test", "Section_Test");
+    bool isEverySectionRead = deserializer.DeserializePropertyAs<std::string>("Scene_Name") == "Section_Scene";
+    for (int sectionIndex = 0; sectionIndex < 8; sectionIndex++)
+    {
+        std::map<std::string, int> section = deserializer.DeserializePropertyAs<std::map<std::string, int>>("Section_" + std::to_string(sectionIndex));
+        isEverySectionRead = isEverySectionRead && section["Index"] == sectionIndex && section["Count"] == sectionIndex * 2;
+    }
+    deserializer.EndDeserialization();
+
+    Check(isEverySectionRead, "Sections built in parallel are all written out");
+}
+
+void CompactSerializationTest()
+{
+    // Compact documents are a single flow style line, and read back exactly like block style ones.
+    Speculo::Serializer_Text serializer(Speculo::Serializer_Operation_Type::Serialization, "../UnitTests/Compact_Test", "Compact_Test", Speculo::Serializer_Text_Flags_Compact);
+    serializer.SerializeProperty("Player_Speed", 15);
+    serializer.SerializeProperty("Player_Location", Speculo::Vector2(3, 5));
+    serializer.EndSerialization();
+
+    std::string fileContents;
+    Speculo::FileSystem::ReadFileContents("../UnitTests/Compact_Test.yml", fileContents);
+
+    Speculo::Serializer_Text deserializer(Speculo::Serializer_Operation_Type::Deserialization, "../UnitTests/Compact_Test", "Compact_Test");
+    const int playerSpeed = deserializer.DeserializePropertyAs<int>("Player_Speed");
+    const Speculo::Vector2 playerLocation = deserializer.DeserializePropertyAs<Speculo::Vector2>("Player_Location");
+    deserializer.EndDeserialization();
+
+    Check(std::count(fileContents.begin(), fileContents.end(), '\n') <= 1 && playerSpeed == 15 && playerLocation.y == 5.0f, "Compact documents fit on one line and round trip");
+}
+
+void SharedSerializationTest()
+{
+    // Shared objects are written once and aliased after, and come back as one instance.
+    std::shared_ptr<Speculo::Vector3> sharedLocation = std::make_shared<Speculo::Vector3>(4.0f, 5.0f, 6.0f);
+
+    Speculo::Serializer_Text serializer(Speculo::Serializer_Operation_Type::Serialization, "../UnitTests/Shared_Test", "Shared_Test");
+    serializer.SerializeSharedProperty("Spawn_Location", sharedLocation);
+    serializer.SerializeSharedProperty("Camera_Target", sharedLocation);
+    serializer.SerializeDeduplicatedProperty("Spawn_Tint", Speculo::Vector3(1.0f, 1.0f, 1.0f));
+    serializer.SerializeDeduplicatedProperty("Camera_Tint", Speculo::Vector3(1.0f, 1.0f, 1.0f));
+    serializer.EndSerialization();
+
+    std::shared_ptr<Speculo::Vector3> spawnLocation;
+    std::shared_ptr<Speculo::Vector3> cameraTarget;
+
+    Speculo::Serializer_Text deserializer(Speculo::Serializer_Operation_Type::Deserialization, "../UnitTests/Shared_Test", "Shared_Test");
+    deserializer.DeserializeSharedProperty("Spawn_Location", &spawnLocation);
+    deserializer.DeserializeSharedProperty("Camera_Target", &cameraTarget);
+    const Speculo::Vector3 cameraTint = deserializer.DeserializePropertyAs<Speculo::Vector3>("Camera_Tint");
+    deserializer.EndDeserialization();
+
+    Check(spawnLocation && spawnLocation == cameraTarget && cameraTarget->z == 6.0f && cameraTint.y == 1.0f, "Shared and repeated values come back through anchors and aliases");
+}
+
+void BinaryBlobSerializationTest()
+{
+    // Long enough to run through the vectorized path as well as the scalar tail.
+    std::vector<uint8_t> blob(1000);
+    for (size_t byteIndex = 0; byteIndex < blob.size(); byteIndex++)
+    {
+        blob[byteIndex] = static_cast<uint8_t>(byteIndex * 37 + 11);
+    }
+
+    Speculo::Serializer_Text serializer(Speculo::Serializer_Operation_Type::Serialization, "../UnitTests/Blob_Test", "Blob_Test");
+    serializer.SerializeBinary("Blob", blob.data(), blob.size());
+    serializer.EndSerialization();
+
+    std::vector<uint8_t> decodedBlob(16);
+    size_t decodedSize = 0;
+
+    Speculo::Serializer_Text deserializer(Speculo::Serializer_Operation_Type::Deserialization, "../UnitTests/Blob_Test", "Blob_Test");
+    const bool isTooSmallReported = deserializer.DeserializeBinary("Blob", decodedBlob.data(), decodedBlob.size(), &decodedSize) != Speculo::SpeculoResult::SPECULO_SUCCESS && decodedSize == blob.size();
+    decodedBlob.resize(decodedSize);
+    const Speculo::SpeculoResult result = deserializer.DeserializeBinary("Blob", decodedBlob.data(), decodedBlob.size(), &decodedSize);
+    deserializer.EndDeserialization();
+
+    Check(isTooSmallReported && result == Speculo::SpeculoResult::SPECULO_SUCCESS && decodedBlob == blob, "Binary blobs round trip through base64");
+}
+
+void PatchPropertyTest()
+{
+    Speculo::Serializer_Text serializer(Speculo::Serializer_Operation_Type::Serialization, "../UnitTests/Patch_Test", "Patch_Test");
+    serializer.SerializeProperty("Player_Speed", 12345);
+    serializer.SerializeProperty("Player_Name", std::string("Speculo"));
+    for (int propertyIndex = 0; propertyIndex < 10000; propertyIndex++) // Pushes the end of the file well past the first read.
+    {
+        serializer.SerializeProperty("Filler_" + std::to_string(propertyIndex), propertyIndex);
+    }
+    serializer.EndSerialization();
+
+    // Values that fit are written over the old ones, including into padding left behind by an earlier patch.
+    const uintmax_t fileSize = std::filesystem::file_size("../UnitTests/Patch_Test.yml");
+    Speculo::Serializer_Text::PatchProperty("../UnitTests/Patch_Test", "Player_Speed", 7);
+    Speculo::Serializer_Text::PatchProperty("../UnitTests/Patch_Test", "Player_Speed", 99999);
+    const bool isPatchedInPlace = std::filesystem::file_size("../UnitTests/Patch_Test.yml") == fileSize;
+    Speculo::Serializer_Text::PatchProperty("../UnitTests/Patch_Test", "Player_Name", std::string("A name longer than the original"));
+
+    Speculo::Serializer_Text deserializer(Speculo::Serializer_Operation_Type::Deserialization, "../UnitTests/Patch_Test", "Patch_Test");
+    const int playerSpeed = deserializer.DeserializePropertyAs<int>("Player_Speed");
+    const std::string playerName = deserializer.DeserializePropertyAs<std::string>("Player_Name");
+    const int lastFiller = deserializer.DeserializePropertyAs<int>("Filler_9999");
+    deserializer.EndDeserialization();
+
+    Check(isPatchedInPlace && playerSpeed == 99999 && playerName == "A name longer than the original" && lastFiller == 9999, "Single properties are patched in place or spliced in");
+}
+
+struct Test_Counter
+{
+    Test_Counter(int count) : m_Count(count) { }
+
+    int m_Count = 0;
+};
+
+void ConcurrentRegistrationTest()
+{
+    // Lookups running on other threads keep using the tables they found while registration rebuilds them.
+    Speculo::TypeFactory<Test_Counter>& counterFactory = Speculo::Reflect<Test_Counter>("Test_Counter").AddConstructor<int>().AddDataMember(&Test_Counter::m_Count, "Count");
+    const Speculo::TypeDescriptor* counterType = Speculo::Resolve<Test_Counter>();
+
+    std::atomic<bool> isRegistering { true };
+    std::atomic<size_t> failedCount { 0 };
+    std::vector<std::thread> lookupThreads;
+
+    for (int i = 0; i < 4; i++)
+    {
+        lookupThreads.emplace_back([&]()
+        {
+            for (int count = 0; isRegistering || count < 1000; count++)
+            {
+                std::vector<Speculo::Any> arguments;
+                arguments.emplace_back(count);
+
+                Speculo::Any counter = counterType->NewInstance(arguments);
+                if (counter.GetType() != counterType || static_cast<Test_Counter*>(counter.Get())->m_Count != count || !counterType->GetDataMember("Count"))
+                {
+                    failedCount++;
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < 100; i++)
+    {
+        counterFactory.AddDataMember(&Test_Counter::m_Count, "Count_" + std::to_string(i));
+    }
+
+    isRegistering = false;
+    for (std::thread& lookupThread : lookupThreads)
+    {
+        lookupThread.join();
+    }
+
+    Check(failedCount == 0 && counterType->GetDataMembers().size() == 101, "Lookups stay valid while other threads register");
+}
+
+void TypeRegistryTest()
+{
+    constexpr Speculo::TypeId playerTypeId("Test_Player");
+    const Speculo::TypeDescriptor* playerType = Speculo::Resolve<Test_Player>();
+
+    Check(Speculo::Resolve("Test_Player") == playerType && Speculo::Resolve(playerTypeId) == playerType && playerType->GetTypeId() == playerTypeId &&
+          !Speculo::Resolve("Test_Missing"), "Types resolve by name and by TypeId");
+}
+
+void MemberTableTest()
+{
+    // Lookups by name find members registered on bases as well.
+    const Speculo::TypeDescriptor* heroType = Speculo::Resolve<Test_Hero>();
+    Test_Hero hero;
+    hero.m_Health = 60;
+
+    Speculo::DataMember* healthMember = heroType->GetDataMember("Health");
+    Speculo::Any health = healthMember ? healthMember->Get(Speculo::AnyRef(hero)) : Speculo::Any();
+
+    Check(heroType->GetDataMembers().size() == 5 && heroType->GetDataMember("Mana") && !heroType->GetDataMember("Missing") && health.TryCast<int>() &&
+          *health.TryCast<int>() == 60, "Member lookups include base members");
+}
+
+void FunctionInvokeTest()
+{
+    Test_Player player;
+    const Speculo::TypeDescriptor* playerType = Speculo::Resolve<Test_Player>();
+
+    playerType->GetMemberFunction("SetLevel")->Invoke(player, 9);
+    Speculo::Any level = playerType->GetMemberFunction("GetLevel")->Invoke(player);
+
+    Check(player.GetLevel() == 9 && level.TryCast<int>() && *level.TryCast<int>() == 9 && !playerType->GetMemberFunction("SetLevel")->Invoke(player),
+          "Member functions are invoked with and without arguments");
+}
+
+void InvokerTest()
+{
+    Test_Player player;
+    const Speculo::Function* setLevel = Speculo::Resolve<Test_Player>()->GetMemberFunction("SetLevel");
+
+    // Handles are only bound when the signature matches the reflected declaration exactly.
+    Speculo::Invoker<void(Test_Player&, int)> setLevelInvoker = setLevel->Bind<void(Test_Player&, int)>();
+    setLevelInvoker(player, 12);
+
+    Check(setLevelInvoker && !setLevel->Bind<void(Test_Player&, float)>() && player.GetLevel() == 12, "Invokers call through to the bound function");
+}
+
+void AnyStorageTest()
+{
+    // Values that fit the buffer are stored inline, larger ones on the heap, whatever the buffer size.
+    Speculo::BasicAny<8> smallValue(2.5);
+    Speculo::BasicAny<8> largeValue(Test_Transform{});
+    Speculo::BasicAny<8> copiedValue(largeValue);
+
+    const char* smallStorage = reinterpret_cast<const char*>(&smallValue);
+    const char* largeStorage = reinterpret_cast<const char*>(&largeValue);
+    const bool isSmallInline = static_cast<const char*>(smallValue.Get()) >= smallStorage && static_cast<const char*>(smallValue.Get()) < smallStorage + sizeof(smallValue);
+    const bool isLargeInline = static_cast<const char*>(largeValue.Get()) >= largeStorage && static_cast<const char*>(largeValue.Get()) < largeStorage + sizeof(largeValue);
+
+    Check(isSmallInline && !isLargeInline && *smallValue.TryCast<double>() == 2.5 && copiedValue.Get() != largeValue.Get() && copiedValue.TryCast<Test_Transform>()->m_Scale.x == 1.0f,
+          "Any stores small values inline and copies large ones");
+}
+
+void AnyOperationsTest()
+{
+    Speculo::Any name(std::string("Speculo"));
+    Speculo::Any copiedName(name);
+    Speculo::Any movedName(std::move(name));
+
+    Speculo::Any number(5);
+    number.Swap(movedName);
+
+    Check(!name && *copiedName.TryCast<std::string>() == "Speculo" && *number.TryCast<std::string>() == "Speculo" && *movedName.TryCast<int>() == 5,
+          "Any copies, moves and swaps values of different types");
+}
+
+void HierarchyCastTest()
+{
+    Test_Hero hero;
+    Speculo::Any heroRef = Speculo::AnyRef(hero);
+
+    const Speculo::TypeDescriptor* heroType = Speculo::Resolve<Test_Hero>();
+    const Speculo::TypeDescriptor* playerType = Speculo::Resolve<Test_Player>();
+
+    Check(heroType->IsA(playerType) && !playerType->IsA(heroType) && heroRef.TryCast<Test_Player>() == static_cast<Test_Player*>(&hero) && !heroRef.TryCast<Test_Transform>(),
+          "Derived types cast to their bases only");
+}
+
+void ConversionTest()
+{
+    // The converted value keeps its own type whatever the size of the Any it is converted from.
+    Speculo::BasicAny<8> smallFeet = Speculo::BasicAny<8>(Test_Meters{ 10.0 }).TryConvert<Test_Feet>();
+    Speculo::Any feet = Speculo::Any(Test_Meters{ 4.0 }).TryConvert<Test_Feet>();
+
+    Check(smallFeet.GetType() == Speculo::Resolve<Test_Feet>() && smallFeet.TryCast<Test_Feet>()->m_Value == 32.5 && feet.TryCast<Test_Feet>()->m_Value == 13.0 &&
+          !Speculo::Any(Test_Feet{}).TryConvert<Test_Meters>(), "Values convert through registered conversions");
+}
+
+void ReflectedConstructionTest()
+{
+    const Speculo::Constructor* fragileConstructor = Speculo::Resolve<Test_Fragile>()->GetConstructor<int>();
+
+    Speculo::Arena arena;
+    Test_Fragile* fragiles = static_cast<Test_Fragile*>(fragileConstructor->ConstructN(arena, 3, 7));
+    const bool isBatchBuilt = fragiles && fragiles[2].m_Value == 7 && Test_Fragile::m_LiveCount == 3;
+    arena.Reset();
+
+    // Arguments that do not fit are refused before any memory is taken.
+    Speculo::Arena unusedArena;
+    const bool isMismatchRefused = !fragileConstructor->ConstructN(unusedArena, 3, std::string("Seven")) && unusedArena.GetCapacity() == 0;
+
+    alignas(Test_Fragile) unsigned char storage[sizeof(Test_Fragile) * 4];
+    void* fragile = fragileConstructor->NewInstanceAt(storage, 5);
+    const bool isBuiltInPlace = fragile == storage && static_cast<Test_Fragile*>(fragile)->m_Value == 5;
+    fragileConstructor->Destroy(fragile);
+
+    // A constructor throwing partway through a batch leaves none of the earlier objects behind.
+    bool isRethrown = false;
+    Test_Fragile::m_FailAfter = 2;
+    try
+    {
+        fragileConstructor->ConstructN(storage, 4, 7);
+    }
+    catch (const std::runtime_error&)
+    {
+        isRethrown = true;
+    }
+    Test_Fragile::m_FailAfter = -1;
+
+    Check(isBatchBuilt && isMismatchRefused && isBuiltInPlace && isRethrown && Test_Fragile::m_LiveCount == 0, "Reflected constructors build objects in place and in batches");
+}
+
+void ConstructorOverloadTest()
+{
+    // Arguments pick the cheapest overload, converting them if nothing takes them as they are.
+    const Speculo::TypeDescriptor* fragileType = Speculo::Resolve<Test_Fragile>();
+    const Speculo::Constructor* feetConstructor = fragileType->GetConstructor<Test_Feet>();
+
+    std::vector<Speculo::Any> arguments;
+    arguments.emplace_back(Test_Meters{ 2.0 });
+    Speculo::Any fragile = fragileType->NewInstance(arguments);
+
+    Check(feetConstructor && feetConstructor != fragileType->GetConstructor<int>() && fragileType->GetConstructor<Test_Meters>() == feetConstructor &&
+          !fragileType->GetConstructor<std::string>() && fragile.TryCast<Test_Fragile>() && fragile.TryCast<Test_Fragile>()->m_Value == 6, "Constructor overloads are resolved by argument types");
+}
+
+void FreezeTest()
+{
+    // Metadata looked up before the freeze stays usable after it. Runs last, as nothing can be registered afterwards.
+    Test_Player player;
+    player.m_Health = 35;
+
+    Speculo::DataMember* healthMember = Speculo::Resolve<Test_Player>()->GetDataMember("Health");
+    Speculo::Invoker<void(Test_Player&, int)> setLevelInvoker = Speculo::Resolve<Test_Player>()->GetMemberFunction("SetLevel")->Bind<void(Test_Player&, int)>();
+
+    Speculo::Freeze();
+    setLevelInvoker(player, 4);
+    Speculo::Any health = healthMember->Get(Speculo::AnyRef(player));
+
+    Speculo::Reflect<Test_Hero>("Test_Hero").AddDataMember(&Test_Hero::m_Mana, "Late_Mana");
+
+    Check(*health.TryCast<int>() == 35 && player.GetLevel() == 4 && Speculo::Resolve<Test_Player>()->GetDataMember("Health") && !Speculo::Resolve<Test_Hero>()->GetDataMember("Late_Mana"),
+          "Metadata from before Freeze stays valid and later registration is refused");
+}
+
+constexpr Speculo::ReflectionSymbol Test_Player_Symbols[] =
+{
+    SPECULO_SYMBOL_TYPE(Test_Player),
+    SPECULO_SYMBOL_DATA_MEMBER(Test_Player, m_Name),
+    SPECULO_SYMBOL_DATA_MEMBER(Test_Player, m_Health),
+};
+
+void ReflectionImageTest()
+{
+    // Test_Player was already registered through Reflect<T>(), so loading its symbols would register its members twice.
+    const bool isLoaded = Speculo::ReflectionImage::Load("../UnitTests/Reflection_Image", Test_Player_Symbols);
+
+    Check(!isLoaded && Speculo::Resolve<Test_Player>()->GetDataMembers().size() == 4 && !Speculo::Details::GetRegistrationFrozen(), "Images are not loaded over types registered by other means");
+}
+
+struct Test_Stats
+{
+    int m_Strength = 0;
+    int m_Agility = 0;
+
+    REFLECT_STATIC_BEGIN(Test_Stats)
+        REFLECT_STATIC_MEMBER(m_Strength)
+        REFLECT_STATIC_MEMBER(m_Agility)
+    REFLECT_STATIC_END()
+};
+
+struct Test_Boosted_Stats : Test_Stats
+{
+    int m_Bonus = 0;
+};
+
+void StaticReflectionTest()
+{
+    Test_Stats stats;
+    stats.m_Strength = 3;
+    Test_Stats otherStats = stats;
+
+    int memberSum = 0;
+    Speculo::ForEachMember(stats, [&memberSum](const char*, int member) { memberSum += member; });
+    const bool isEqual = Speculo::MembersEqual(stats, otherStats) && Speculo::HashMembers(stats) == Speculo::HashMembers(otherStats);
+
+    otherStats.m_Agility = 1;
+
+    // Derived classes only count as statically reflected with a block of their own, rather than comparing through their base's members.
+    Check(isEqual && memberSum == 3 && !Speculo::MembersEqual(stats, otherStats) && Speculo::GetStaticMemberCount<Test_Stats>() == 2 &&
+          !Speculo::IsStaticallyReflected<Test_Boosted_Stats>::value, "Static member tables visit exactly their own type");
+}
+
+void FrozenSerializationTest()
+{
+    // Once frozen, plans are looked up without locking, so workers emitting the same type all see one complete plan.
+    Test_Player player;
+    player.m_Name = "Frozen";
+    player.m_Health = 60;
+
+    std::vector<std::string> documents(4);
+    std::vector<std::thread> workers;
+    for (std::string& document : documents)
+    {
+        workers.emplace_back([&player, &document]()
+        {
+            YAML::Emitter emitter;
+            if (Speculo::Serializer_Text_Reflection::Emit(emitter, &player, Speculo::Resolve<Test_Player>()))
+            {
+                document = emitter.c_str();
+            }
+        });
+    }
+
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    Check(!documents[0].empty() && documents[0].find("Frozen") != std::string::npos && std::count(documents.begin(), documents.end(), documents[0]) == 4,
+          "Frozen reflected types are emitted concurrently");
+}
+
 SIGNAL_RETURN_ONE_PARAM(MultiDelegate, int, double);
 MultiDelegate multiDelegate;
 
@@ -133,6 +739,18 @@ private:
     std::vector<Connection> m_Connections; // A vector of delegate connections.
 };
 
+void CatalogScanTest()
+{
+    // Only the metadata of each file is read.
+    Speculo::Serializer_Catalog unitTestCatalog;
+    unitTestCatalog.ScanDirectory("../UnitTests");
+
+    for (const Speculo::Serializer_Catalog_Entry* catalogEntry : unitTestCatalog.FindCompatibleFiles("Material"))
+    {
+        std::cout << catalogEntry->m_FilePath << "\n";
+    }
+}
+
 int main(int argc, int argv[])
 {
     {
@@ -154,6 +772,7 @@ int main(int argc, int argv[])
     // ===========================================================================
 
     Speculo::Reflect<int>("int").AddMemberFunction(&Print<int>, "Print");
+    RegisterReflectedTestTypes();
     auto a = Speculo::Resolve("int");
     Speculo::Resolve("int")->GetMemberFunction("Print")->Invoke(a, 5);
 
@@ -162,9 +781,37 @@ int main(int argc, int argv[])
 
     TextSerializationTest();
     TextDeserializationTest();
+    StreamedSerializationTest();
+    SectionSerializationTest();
+    CompactSerializationTest();
+    SharedSerializationTest();
+    BinaryBlobSerializationTest();
+    PatchPropertyTest();
 
     MaterialSerializationTest();
     MaterialDeserializationTest();
+
+    LazyDeserializationTest();
+    FailedDeserializationTest();
+    BatchDeserializationTest();
+    ThreadPoolExceptionTest();
+    ReflectedSerializationTest();
+    TypeRegistryTest();
+    MemberTableTest();
+    FunctionInvokeTest();
+    InvokerTest();
+    AnyStorageTest();
+    AnyOperationsTest();
+    HierarchyCastTest();
+    ConversionTest();
+    ReflectedConstructionTest();
+    ConstructorOverloadTest();
+    ConcurrentRegistrationTest();
+    ReflectionImageTest();
+    StaticReflectionTest();
+    CatalogScanTest();
+    FreezeTest();
+    FrozenSerializationTest();
 }
 
 